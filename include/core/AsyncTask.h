@@ -0,0 +1,220 @@
+#ifndef INCLUDE_CORE_ASYNCTASK_H
+#define INCLUDE_CORE_ASYNCTASK_H
+
+#include "core/Execution.h"
+
+#include <QFuture>
+#include <QList>
+#include <QSharedPointer>
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+template <typename T>
+class AsyncTask;
+
+namespace AsyncTaskDetail {
+
+template <typename T>
+struct State {
+    bool finished = false;
+    std::optional<T> value;
+    std::coroutine_handle<> continuation;
+};
+
+template <>
+struct State<void> {
+    bool finished = false;
+    std::coroutine_handle<> continuation;
+};
+
+template <typename T>
+struct PromiseBase {
+    QSharedPointer<State<T>> state = QSharedPointer<State<T>>::create();
+
+    void return_value(T value) {
+        state->value = std::move(value);
+    }
+};
+
+template <>
+struct PromiseBase<void> {
+    QSharedPointer<State<void>> state = QSharedPointer<State<void>>::create();
+
+    void return_void() {}
+};
+
+inline void resumeOnMainThread(std::coroutine_handle<> handle) {
+    Execution::getInstance().dispatchMainThreadTask([handle]() {
+        handle.resume();
+    });
+}
+
+} // namespace AsyncTaskDetail
+
+/**
+ * @brief Coroutine returning T, for composing asynchronous loads on the GUI thread.
+ *
+ * The coroutine starts running as soon as it is called and returns at its
+ * first co_await on unfinished work.  Awaited futures (awaitFuture(),
+ * Loader::loadAsync()) resume it through Execution's main-thread queue, so
+ * the body always runs on the GUI thread and inside the per-frame budget.
+ *
+ * The coroutine runs to completion even if the AsyncTask is discarded, so a
+ * fire-and-forget call is fine.  At most one coroutine may co_await a task.
+ *
+ * Start coroutines on the GUI thread only.
+ */
+template <typename T = void>
+class AsyncTask {
+public:
+    struct promise_type : AsyncTaskDetail::PromiseBase<T> {
+        AsyncTask get_return_object() {
+            return AsyncTask(this->state);
+        }
+
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                // The frame is freed here; the result lives on in the shared state.
+                const QSharedPointer<AsyncTaskDetail::State<T>> state = handle.promise().state;
+                handle.destroy();
+                state->finished = true;
+                const std::coroutine_handle<> continuation = std::exchange(state->continuation, {});
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept {
+            return {};
+        }
+
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+
+    bool isFinished() const {
+        return m_state->finished;
+    }
+
+    bool await_ready() const {
+        return m_state->finished;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        m_state->continuation = handle;
+    }
+
+    T await_resume() {
+        if constexpr (!std::is_void_v<T>) {
+            return *m_state->value;
+        }
+    }
+
+private:
+    explicit AsyncTask(QSharedPointer<AsyncTaskDetail::State<T>> state)
+        : m_state(std::move(state))
+    {
+    }
+
+    QSharedPointer<AsyncTaskDetail::State<T>> m_state;
+};
+
+/**
+ * @brief Awaitable for a QFuture; the awaiting coroutine resumes on the GUI thread.
+ *
+ * A cancelled or failed future resumes with a default-constructed T; the
+ * exception of a failed one is dropped.
+ */
+template <typename T>
+class FutureAwaiter {
+public:
+    explicit FutureAwaiter(QFuture<T> future)
+        : m_future(std::move(future))
+    {
+    }
+
+    bool await_ready() const {
+        return m_future.isFinished();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        // Exactly one of the three runs: then() is skipped for a failed or
+        // cancelled future, onFailed() takes the failure and onCanceled() only
+        // sees a cancellation.  The awaiter lives in the suspended frame, so
+        // m_failed is still there to be set.
+        const auto resume = [handle]() {
+            AsyncTaskDetail::resumeOnMainThread(handle);
+        };
+        QFuture<void> resumed;
+        if constexpr (std::is_void_v<T>) {
+            resumed = m_future.then(QtFuture::Launch::Sync, resume);
+        } else {
+            resumed = m_future.then(QtFuture::Launch::Sync, [resume](const T&) {
+                resume();
+            });
+        }
+        resumed
+            .onFailed([this, resume]() {
+                m_failed = true;
+                resume();
+            })
+            .onCanceled(resume);
+    }
+
+    T await_resume() {
+        if constexpr (!std::is_void_v<T>) {
+            // A failed future has no result to read; result() would rethrow.
+            if (m_failed || m_future.isCanceled() || m_future.resultCount() == 0) {
+                return T();
+            }
+            return m_future.result();
+        }
+    }
+
+private:
+    QFuture<T> m_future;
+    bool m_failed = false;
+};
+
+template <typename T>
+FutureAwaiter<T> awaitFuture(QFuture<T> future) {
+    return FutureAwaiter<T>(std::move(future));
+}
+
+/**
+ * @brief Wait for every task; results come back in the order of tasks.
+ *
+ * The tasks are already running, so their waits overlap; this only collects
+ * them.
+ */
+template <typename T>
+AsyncTask<QList<T>> whenAll(QList<AsyncTask<T>> tasks) {
+    QList<T> results;
+    results.reserve(tasks.size());
+    for (AsyncTask<T>& task : tasks) {
+        results.append(co_await task);
+    }
+    co_return results;
+}
+
+inline AsyncTask<void> whenAll(QList<AsyncTask<void>> tasks) {
+    for (AsyncTask<void>& task : tasks) {
+        co_await task;
+    }
+}
+
+#endif // INCLUDE_CORE_ASYNCTASK_H
@@ -0,0 +1,77 @@
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <QAtomicInt>
+#include <QSharedPointer>
+
+/**
+ * @brief Cooperative cancellation handle shared between a requester and its work.
+ *
+ * Work that several requesters share (a coalesced load) gives each of them a
+ * token from join(); the work counts as cancelled only once every holder has
+ * called cancel().  Workers poll isCancelled() at convenient points.
+ *
+ * A default-constructed token is invalid and never reports cancellation.
+ * Copies of a token are the same holder.  All methods are thread-safe.
+ */
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    static CancellationToken create() {
+        CancellationToken token;
+        token.m_holders = QSharedPointer<QAtomicInt>::create(1);
+        token.m_withdrawn = QSharedPointer<QAtomicInt>::create(0);
+        return token;
+    }
+
+    /**
+     * @brief New holder of the same work.
+     * @return An invalid token if the work has already been cancelled.
+     */
+    CancellationToken join() const {
+        if (!isValid()) {
+            return {};
+        }
+        int holders = m_holders->loadAcquire();
+        do {
+            if (holders <= 0) {
+                return {};
+            }
+        } while (!m_holders->testAndSetOrdered(holders, holders + 1, holders));
+        CancellationToken token;
+        token.m_holders = m_holders;
+        token.m_withdrawn = QSharedPointer<QAtomicInt>::create(0);
+        return token;
+    }
+
+    /**
+     * @brief Withdraw this holder's interest; repeated calls have no further effect.
+     */
+    void cancel() {
+        if (isValid() && m_withdrawn->testAndSetOrdered(0, 1)) {
+            m_holders->deref();
+        }
+    }
+
+    bool isCancelled() const {
+        return isValid() && m_holders->loadAcquire() <= 0;
+    }
+
+    bool isValid() const {
+        return !m_holders.isNull();
+    }
+
+    /**
+     * @brief True if both tokens are holders of the same work.
+     */
+    bool isSameWork(const CancellationToken& other) const {
+        return m_holders == other.m_holders;
+    }
+
+private:
+    QSharedPointer<QAtomicInt> m_holders;
+    QSharedPointer<QAtomicInt> m_withdrawn;
+};
+
+#endif // CANCELLATIONTOKEN_H
@@ -1,22 +1,58 @@
 #ifndef EXECUTION_H
 #define EXECUTION_H
 
+#include "core/CancellationToken.h"
+#include "core/TaskScheduler.h"
+#include "core/TimerWheel.h"
+
 #include <QElapsedTimer>
-#include <QRunnable>
+#include <QFuture>
+#include <QList>
+#include <QMutex>
 #include <QThread>
-#include <QThreadPool>
-#include <QTimer>
+
+#include <functional>
+#include <utility>
 
 /**
  * @brief Global execution singleton for timing and task dispatch.
  *
  * Execution upgrades the old Timer role by:
  * - Keeping frame timing/fixed update information
- * - Dispatching asynchronous tasks through an internal thread pool
+ * - Dispatching asynchronous tasks and task graphs through a work-stealing
+ *   TaskScheduler
  * - Dispatching delayed/timed tasks
+ *
+ * Async tasks are queued per priority class and a worker always takes the most
+ * urgent one.  Waiting tasks age: every execution.priority_aging_ms spent in
+ * the queue counts as one class more urgent, so Background work still runs
+ * under a steady stream of Visible requests.  Tasks whose CancellationToken
+ * is cancelled before a worker picks them up are dropped without running.
+ *
+ * Continuations inside a task graph skip that queue: they run on the worker
+ * that released them (or one that steals them), ahead of newly queued work.
+ *
+ * Work that must happen on the GUI thread (publishing load results) goes
+ * through dispatchMainThreadTask() instead of a queued invocation, so a burst
+ * of completions is spread over several frames: each frame runs queued tasks
+ * for at most execution.main_thread_budget_us.
  */
 class Execution {
 public:
+    enum class Priority {
+        Immediate,   // needed for the current frame
+        Visible,     // needed on screen soon (default)
+        Prefetch,    // speculative lookahead
+        Background   // housekeeping, never user-visible
+    };
+    static constexpr int PriorityCount = 4;
+
+    enum class TimerTarget {
+        Pool,        // dispatched as an async task at the timer's priority
+        MainThread   // queued with dispatchMainThreadTask()
+    };
+    static_assert(PriorityCount == TaskScheduler::PriorityCount);
+
     static Execution& getInstance();
 
     void initialize();
@@ -33,27 +69,111 @@ public:
 
     void reset();
 
+    /**
+     * @brief Mark the frame loop idle until the next update().
+     *
+     * The time until then is not simulated: that update() reports a zero
+     * delta and adds nothing to the fixed-update accumulator, so waking up
+     * does not trigger a burst of catch-up fixed updates.
+     */
+    void suspendFrameClock();
+    float getIdleTime() const;
+
     int getMaxThreadCount() const;
     void setMaxThreadCount(int threadCount);
+    int getActiveThreadCount() const;
+    int getQueuedTaskCount(Priority priority) const;
+    quint64 getDroppedTaskCount() const;
+    quint64 getStolenTaskCount() const;
+
+    /**
+     * @brief Queue a task on the scheduler.
+     * @return Task id usable with raiseTaskPriority() while the task is queued.
+     */
+    template <typename Callable>
+    quint64 dispatchAsyncTask(Callable task, Priority priority = Priority::Visible,
+                              const CancellationToken& token = {}) {
+        return m_scheduler.submit(std::function<void()>(std::move(task)), static_cast<int>(priority), token);
+    }
+
+    /**
+     * @brief Run every task of graph, each after the tasks that precede it.
+     *
+     * Tasks without predecessors are queued at priority; the others start on
+     * a worker as soon as their last predecessor finishes.  Once token is
+     * cancelled, tasks that have not started are dropped and the returned
+     * future is cancelled when the rest have finished.
+     * @param rootTaskIds If given, receives the ids of the queued tasks, for raiseTaskPriority().
+     */
+    QFuture<void> runGraph(TaskGraph graph, Priority priority = Priority::Visible,
+                           const CancellationToken& token = {}, QList<quint64>* rootTaskIds = nullptr);
 
+    /**
+     * @brief Run task after delayMs, on the pool at priority or on the GUI thread.
+     *
+     * Deadlines are rounded up to execution.timer_tick_ms and timers due in
+     * the same tick fire together.  GUI-thread timers go through
+     * dispatchMainThreadTask(), so they also wait for the frame budget.
+     * @return Timer id usable with cancelTimedTask() until the timer fires.
+     */
     template <typename Callable>
-    void dispatchAsyncTask(Callable task) {
-        m_threadPool.start(QRunnable::create(task));
+    quint64 dispatchTimedTask(int delayMs, Callable task, Priority priority = Priority::Visible,
+                              TimerTarget target = TimerTarget::Pool) {
+        return m_timerWheel.add(delayMs, std::function<void()>(std::move(task)),
+                                target == TimerTarget::MainThread, static_cast<int>(priority));
     }
+    /**
+     * @brief Cancel a timed task that has not fired yet.
+     * @return false if it already fired or is unknown.
+     */
+    bool cancelTimedTask(quint64 timerId);
+    TimerWheel::Stats getTimerStats() const;
 
+    /**
+     * @brief Queue a task for the GUI thread, run within the per-frame budget.
+     *
+     * May be called from any thread.  Tasks run in the order they were queued.
+     */
     template <typename Callable>
-    void dispatchTimedTask(int delayMs, Callable task) {
-        QTimer::singleShot(delayMs, [task]() {
-            Execution::getInstance().dispatchAsyncTask(task);
-        });
+    void dispatchMainThreadTask(Callable task) {
+        enqueueMainThreadTask(std::function<void()>(std::move(task)));
     }
 
+    /**
+     * @brief Run queued main-thread tasks until the frame budget is spent.
+     *
+     * At least one task runs per call so a single slow task cannot stall the
+     * queue.  GUI thread only.
+     * @return Number of tasks left for the next frame.
+     */
+    int runMainThreadTasks();
+    /**
+     * @brief Called (from any thread) when queued tasks need a drain scheduled.
+     *
+     * Called when a task is queued and no wake-up is outstanding since the
+     * last runMainThreadTasks(), so a wake-up that ends up not draining does
+     * not stall later tasks.  The wake-up returns false if it cannot arrange a
+     * drain; then, as without a wake-up, the queue drains from the event loop,
+     * one budget per turn.
+     */
+    void setMainThreadWakeup(std::function<bool()> wakeup);
+    int getMainThreadTaskCount() const;
+    int getMainThreadTasksRunLastFrame() const;
+
+    /**
+     * @brief Move a still-queued task to a more urgent class; never lowers priority.
+     * @return false if the task already started or is unknown.
+     */
+    bool raiseTaskPriority(quint64 taskId, Priority priority);
+
 private:
     Execution();
     ~Execution() = default;
     Execution(const Execution&) = delete;
     Execution& operator=(const Execution&) = delete;
 
+    void enqueueMainThreadTask(std::function<void()> task);
+
     QElapsedTimer m_runtimeTimer;
     qint64 m_lastFrameNs;
     qint64 m_lastFixedUpdateNs;
@@ -67,7 +187,21 @@ private:
     float m_fpsAccumulator;
     int m_fpsFrameCount;
 
-    QThreadPool m_threadPool;
+    bool m_frameClockSuspended;
+    qint64 m_idleNs;
+
+    TaskScheduler m_scheduler;
+
+    mutable QMutex m_mainThreadMutex;
+    QList<std::function<void()>> m_mainThreadTasks;
+    std::function<bool()> m_mainThreadWakeup;
+    // A wake-up was issued and no drain has started since.
+    bool m_mainThreadWakePending;
+    qint64 m_mainThreadBudgetNs;
+    int m_mainThreadTasksRunLastFrame;
+
+    // Declared after m_scheduler: destroyed first, as it dispatches into it.
+    TimerWheel m_timerWheel;
 };
 
 #endif // EXECUTION_H
@@ -2,15 +2,24 @@
 #define GAMEMANAGER_H
 
 #include <QObject>
+#include "core/AsyncTask.h"
+#include "core/CancellationToken.h"
 #include "scene/Scene.h"
+#include <QAtomicInt>
 #include <QHash>
+#include <QList>
 #include <QColor>
+#include <QMutex>
 #include <QPointer>
 #include <QSharedPointer>
 #include <QQuickWindow>
+#include <QSet>
 #include <QString>
+#include <QStringList>
 #include <QVariant>
 
+class LoadGroup;
+
 /**
  * @brief GameManager singleton – central controller for game logic and flow.
  *
@@ -18,6 +27,7 @@
  * - Scene management (loading, switching, unloading)
  * - Game-state lifecycle (Stopped / Running / Paused)
  * - Story-step tracking and persistence
+ * - Story-lookahead asset prefetching
  * - Screen navigation
  *
  * Public interface is intentionally minimal: callers read/write Q_PROPERTYs
@@ -32,11 +42,21 @@ class GameManager : public QObject {
     Q_PROPERTY(int savedStep READ getSavedStep NOTIFY savedStepChanged)
     Q_PROPERTY(QString currentScreen READ getCurrentScreen WRITE setCurrentScreen NOTIFY currentScreenChanged)
     Q_PROPERTY(QString currentScreenUrl READ getCurrentScreenUrl NOTIFY currentScreenChanged)
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    Q_PROPERTY(qreal loadProgress READ getLoadProgress NOTIFY loadProgressChanged)
 
 public:
     enum class State { Stopped, Running, Paused };
     Q_ENUM(State)
 
+    struct FrameStats {
+        // Frames that ran Execution::update() and the active scene's updates.
+        quint64 activeFrames = 0;
+        // Frames rendered while idle (QML animations, resizes) that skipped them.
+        quint64 idleFrames = 0;
+        quint64 idlePeriods = 0;
+    };
+
     static GameManager& getInstance();
     static void setInstance(GameManager* instance);
     explicit GameManager(QObject* parent = nullptr);
@@ -44,16 +64,44 @@ public:
 
     void initialize();
     void attachRenderWindow(QQuickWindow* window);
+    /**
+     * @brief Run the scene updates on the next frame and make sure one is rendered.
+     *
+     * Wakes the frame loop from idle.  Thread-safe.
+     */
+    Q_INVOKABLE void requestFrame();
+    bool isIdle() const;
+    FrameStats getFrameStats() const;
     void handleApplicationStateChange(Qt::ApplicationState state);
 
     // Scene management
     void addScene(const QString& name, QSharedPointer<Scene> scene);
     bool removeScene(const QString& name);
     QSharedPointer<Scene> getScene(const QString& name) const;
+    /**
+     * @brief Switch to the named scene.
+     *
+     * The scene is initialized and updated only once the assets its items
+     * reference are loaded (at once when they are already cached).
+     */
     bool setActiveScene(const QString& name);
     QSharedPointer<Scene> getActiveScene() const;
     const QString& getActiveSceneName() const;
 
+    // Memory pressure (see MemoryPressure)
+    /**
+     * @brief Drop queued story prefetches and cancel the ones in flight.
+     */
+    void cancelPrefetch();
+    /**
+     * @brief Clear the items of every scene except the active one.
+     *
+     * Released scenes are rebuilt from their source the next time they are
+     * made active.
+     * @return Number of scenes released.
+     */
+    int releaseInactiveScenes();
+
     // State
     State getState() const;
     QString getGameState() const;
@@ -65,6 +113,11 @@ public:
     QString getCurrentScreen() const;
     QString getCurrentScreenUrl() const;
     void setCurrentScreen(const QString& screen);
+    bool isLoading() const;
+    /**
+     * @brief Fraction of the current shot load done, by source bytes (0..1).
+     */
+    qreal getLoadProgress() const;
 
     // Invokable actions exposed to QML
     Q_INVOKABLE void setState(State newState);
@@ -77,9 +130,23 @@ public:
     Q_INVOKABLE QString emotionEmoji(const QString& emotion) const;
     Q_INVOKABLE QColor emotionColor(const QString& emotion, const QColor& baseColor) const;
     Q_INVOKABLE QVariantMap getGameConstants() const;
+    /**
+     * @brief Load the assets of the shot that step belongs to, plus screenAssets, as one LoadGroup.
+     *
+     * Covers the steps from step to the end of its shot.  loading and
+     * loadProgress follow the group; a new call cancels the previous one.
+     */
+    Q_INVOKABLE void loadShot(const QVariantList& storyData, int step, const QStringList& screenAssets = {});
 
 public slots:
     void processFrame();
+    /**
+     * @brief Re-apply scenes built from filePath (see ResourceWatcher::fileChanged).
+     *
+     * The file is parsed on a worker; only items whose properties changed are
+     * rebuilt, afterwards on the GUI thread.
+     */
+    void reloadScenesFromFile(const QString& filePath);
 
 signals:
     void gameStateChanged();
@@ -87,6 +154,11 @@ signals:
     void currentStoryStepChanged();
     void savedStepChanged();
     void currentScreenChanged();
+    void loadingChanged();
+    void loadProgressChanged();
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private:
     GameManager(const GameManager&) = delete;
@@ -95,16 +167,62 @@ private:
     void loadScenesFromResources();
     void update();
     void fixedUpdate();
+    void schedulePrefetch(const QVariantList& storyData, int fromStep);
+    void pumpPrefetch();
+    void cancelShotLoad();
+    void setLoadProgress(qreal progress);
+    void finishShotLoad();
+    AsyncTask<> setUpActiveScene(QSharedPointer<Scene> scene);
+    void applySceneReloads();
+    void drainMainThreadTasks();
+    void wakeMainThreadDrain();
+    bool isRenderingFrames() const;
+    bool hasPendingFrameWork();
+    void scheduleFrame();
+
+    struct SceneReload {
+        QWeakPointer<Scene> scene;
+        QList<PropertyMap> items;
+    };
 
     State m_state;
     QHash<QString, QSharedPointer<Scene>> m_scenes;
     QSharedPointer<Scene> m_activeScene;
     QString m_activeSceneName;
+    // False until setUpActiveScene() has loaded the scene's assets and
+    // initialized it; the scene gets no updates before.
+    bool m_activeSceneReady;
     bool m_frameUpdateInProgress;
+    // On-demand rendering: frames are requested only while there is per-frame
+    // work.  Written by processFrame, which may run on the render thread.
+    bool m_onDemandRendering;
+    QAtomicInt m_frameRequested;
+    QAtomicInt m_idle;
+    QAtomicInteger<quint64> m_activeFrameCount;
+    QAtomicInteger<quint64> m_idleFrameCount;
+    QAtomicInteger<quint64> m_idlePeriodCount;
     QPointer<QQuickWindow> m_renderWindow;
     int m_currentStoryStep;
     QString m_currentScreen;
     mutable QVariantMap m_cachedGameConstants;
+    // Filled from QML calls and drained on the GUI thread; in-flight loads are
+    // forgotten by the worker that finishes them.
+    QMutex m_prefetchMutex;
+    QStringList m_prefetchQueue;
+    QHash<quint64, CancellationToken> m_prefetchTokens;
+    quint64 m_nextPrefetchId;
+    // The shot the game screen waits for; GUI thread only.
+    QSharedPointer<LoadGroup> m_shotLoad;
+    qreal m_loadProgress;
+    // Parsed on workers, applied on the GUI thread.  The mutex serialises
+    // applying them, releasing and rebuilding scenes and switching the active
+    // scene against processFrame's scene updates and pending-work checks,
+    // which may run on the render thread.
+    QMutex m_sceneReloadMutex;
+    QList<SceneReload> m_sceneReloads;
+    QSet<const Scene*> m_releasedScenes;
+    // Set while a drain is posted from the render thread to the GUI thread.
+    QAtomicInt m_mainThreadDrainPosted;
 };
 
 #endif // GAMEMANAGER_H
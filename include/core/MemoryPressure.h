@@ -0,0 +1,83 @@
+#ifndef INCLUDE_CORE_MEMORYPRESSURE_H
+#define INCLUDE_CORE_MEMORYPRESSURE_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <Qt>
+
+/**
+ * @brief Releases cached data in tiers when the process should shrink.
+ *
+ * Triggers:
+ * - Application state: Inactive (on desktop, merely unfocused) releases
+ *   only prefetches; Hidden or Suspended releases every tier.
+ * - Resident set size (Linux, /proc/self/statm), polled every
+ *   memory.poll_interval_ms: crossing memory.rss_threshold_mb releases tier
+ *   by tier until RSS is back under the threshold.  It fires again only after
+ *   RSS has dropped below the threshold once.  A threshold of 0 disables it.
+ *
+ * Tiers, cheapest to rebuild first:
+ * 1. Prefetch: story prefetches are cancelled and cache entries they
+ *    loaded that nobody has looked up yet are dropped.
+ * 2. OffscreenTextures: textures in ResourceCache not held by a
+ *    ResourceHandle.  Items of every loaded scene hold theirs,
+ *    active or not, so this only frees textures no scene item uses.
+ * 3. InactiveScenes: items of every scene but the active one, then the
+ *    textures only those items held.
+ *
+ * Nothing is reloaded on resume; released data is rebuilt on its next use.
+ * Each event logs the bytes it released from the cache and the RSS change.
+ *
+ * Lives on the GUI thread.
+ */
+class MemoryPressure : public QObject {
+    Q_OBJECT
+public:
+    enum class Tier { Prefetch, OffscreenTextures, InactiveScenes };
+
+    struct Stats {
+        quint64 events = 0;
+        qint64 releasedBytes = 0;
+        int releasedScenes = 0;
+    };
+
+    static MemoryPressure& getInstance();
+
+    void initialize();
+
+    /**
+     * @brief Release every tier up to and including deepest.
+     * @param reason Logged with the event.
+     * @param targetResidentBytes Stop after the first tier that brings RSS
+     *        below this; 0 runs every tier up to deepest.
+     * @return Bytes released from ResourceCache.
+     */
+    qint64 relieve(Tier deepest, const QString& reason, qint64 targetResidentBytes = 0);
+
+    /**
+     * @brief Current resident set size in bytes, or -1 where unsupported.
+     */
+    static qint64 readResidentBytes();
+
+    Stats getStats() const;
+
+public slots:
+    void handleApplicationStateChange(Qt::ApplicationState state);
+
+private:
+    MemoryPressure();
+    ~MemoryPressure() override = default;
+    MemoryPressure(const MemoryPressure&) = delete;
+    MemoryPressure& operator=(const MemoryPressure&) = delete;
+
+    void pollResidentSize();
+    static const char* tierName(Tier tier);
+
+    QTimer m_pollTimer;
+    qint64 m_thresholdBytes;
+    bool m_overThreshold;
+    Stats m_stats;
+};
+
+#endif // INCLUDE_CORE_MEMORYPRESSURE_H
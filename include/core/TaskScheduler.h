@@ -0,0 +1,165 @@
+#ifndef INCLUDE_CORE_TASKSCHEDULER_H
+#define INCLUDE_CORE_TASKSCHEDULER_H
+
+#include "core/CancellationToken.h"
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <functional>
+#include <utility>
+
+/**
+ * @brief A set of tasks and the order constraints between them, run as one unit.
+ *
+ * Build the graph with add() and precede(), then hand it to
+ * Execution::runGraph().  A task starts once every task that precedes it has
+ * finished; tasks without such a constraint may run in parallel.
+ */
+class TaskGraph {
+public:
+    using Node = int;
+
+    template <typename Callable>
+    Node add(Callable work) {
+        NodeSpec node;
+        node.work = std::function<void()>(std::move(work));
+        m_nodes.append(std::move(node));
+        return static_cast<Node>(m_nodes.size() - 1);
+    }
+
+    /**
+     * @brief Let after start only once before has finished.
+     */
+    void precede(Node before, Node after);
+
+    int size() const;
+    bool isEmpty() const;
+
+private:
+    friend class TaskScheduler;
+
+    struct NodeSpec {
+        std::function<void()> work;
+        QList<Node> successors;
+        int predecessorCount = 0;
+    };
+
+    QList<NodeSpec> m_nodes;
+};
+
+/**
+ * @brief Work-stealing scheduler behind Execution's async tasks.
+ *
+ * Every worker thread owns a deque.  Tasks released by a finishing task (its
+ * continuations in a TaskGraph) are pushed onto the finishing worker's own
+ * deque and popped from the same end, so a pipeline tends to stay on one
+ * core with warm caches.  An idle worker steals from the opposite end of
+ * another worker's deque.
+ *
+ * Tasks submitted from outside (submit(), graph roots) go to a shared queue
+ * per priority class that workers consult once their own deque is empty.
+ * Waiting there ages tasks as described for Execution, and a task still in
+ * that queue can be moved to a more urgent class.
+ *
+ * Tasks whose token is cancelled before they start are dropped without
+ * running; in a graph they still release their continuations, which are
+ * dropped in turn.
+ *
+ * All methods are thread-safe.
+ */
+class TaskScheduler {
+public:
+    static constexpr int PriorityCount = 4;
+
+    TaskScheduler();
+    ~TaskScheduler();
+
+    /**
+     * @brief Number of workers; effective once, before the first task starts them.
+     *
+     * Once running, the worker count can still grow but never shrinks.
+     */
+    void setWorkerCount(int workerCount);
+    int getWorkerCount() const;
+    int getActiveWorkerCount() const;
+    void setAgingInterval(qint64 agingNs);
+
+    int getQueuedTaskCount(int priority) const;
+    quint64 getDroppedTaskCount() const;
+    quint64 getStolenTaskCount() const;
+
+    /**
+     * @brief Queue a single task in the shared queue of its class.
+     * @return Task id usable with raisePriority() while the task is queued.
+     */
+    quint64 submit(std::function<void()> work, int priority, const CancellationToken& token);
+    /**
+     * @brief Queue the graph's tasks without predecessors; the rest follow as they are released.
+     *
+     * The future finishes when every task has finished or been dropped and is
+     * cancelled if the token was.  A graph with a cycle is rejected with a
+     * cancelled future.
+     * @param rootTaskIds If given, receives the ids of the queued tasks, for raisePriority().
+     */
+    QFuture<void> submitGraph(TaskGraph graph, int priority, const CancellationToken& token,
+                              QList<quint64>* rootTaskIds = nullptr);
+
+    bool raisePriority(quint64 taskId, int priority);
+
+    /**
+     * @brief Stop and join all workers; queued tasks are discarded.
+     */
+    void shutdown();
+
+private:
+    struct GraphRun;
+    struct Task;
+    using TaskRef = QSharedPointer<Task>;
+
+    struct Worker {
+        int index = 0;
+        QThread* thread = nullptr;
+        QMutex dequeMutex;
+        QList<TaskRef> deque;
+    };
+
+    void startWorkersLocked(int workerCount);
+    void workerLoop(Worker* worker);
+    TaskRef takeTask(Worker* worker);
+    TaskRef takeShared();
+    TaskRef steal(Worker* thief);
+    void pushLocal(Worker* worker, const TaskRef& task);
+    void runTask(Worker* worker, const TaskRef& task);
+    quint64 enqueueShared(const TaskRef& task, int priority);
+    void wakeWorker();
+
+    // Guards the worker list and the shared queues.
+    mutable QMutex m_mutex;
+    QList<QSharedPointer<Worker>> m_workers;
+    int m_configuredWorkerCount;
+    QAtomicInt m_stopping;
+
+    QList<TaskRef> m_queues[PriorityCount];
+    QElapsedTimer m_queueClock;
+    qint64 m_agingNs;
+    quint64 m_nextTaskId;
+
+    // Tasks in any deque or shared queue; idle workers sleep while it is zero.
+    QAtomicInt m_pendingTasks;
+    QMutex m_sleepMutex;
+    QWaitCondition m_wakeCondition;
+    int m_sleepingWorkers;
+
+    QAtomicInt m_activeWorkers;
+    QAtomicInteger<quint64> m_droppedTaskCount;
+    QAtomicInteger<quint64> m_stolenTaskCount;
+};
+
+#endif // INCLUDE_CORE_TASKSCHEDULER_H
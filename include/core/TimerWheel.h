@@ -0,0 +1,116 @@
+#ifndef INCLUDE_CORE_TIMERWHEEL_H
+#define INCLUDE_CORE_TIMERWHEEL_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <functional>
+
+/**
+ * @brief Hierarchical timer wheel behind Execution::dispatchTimedTask().
+ *
+ * Time is counted in ticks of execution.timer_tick_ms.  Deadlines are
+ * rounded up to a tick, so timers due within the same tick fire together:
+ * main-thread timers that come due at one wake-up are handed to Execution as
+ * a single task.  Pool timers are dispatched one by one at their priority.
+ *
+ * Four levels of 64 slots each cover 64^4 ticks; later deadlines wait in the
+ * last level and are re-inserted until they are in range.  Inserting,
+ * cancelling and expiring a timer are O(1); a timer moves down a level at
+ * most three times.
+ *
+ * A dedicated thread advances the wheel.  It sleeps until the next tick that
+ * can hold a due timer and is woken by insertions, so an idle wheel costs no
+ * wake-ups.
+ *
+ * All methods are thread-safe.
+ */
+class TimerWheel {
+public:
+    struct Stats {
+        int pending = 0;
+        quint64 fired = 0;
+        quint64 cancelled = 0;
+        // Ticks that fired at least one timer; fired / firingTicks is the
+        // average number of timers coalesced per tick.
+        quint64 firingTicks = 0;
+    };
+
+    TimerWheel();
+    ~TimerWheel();
+
+    /**
+     * @brief Tick length; effective once, before the first timer is added.
+     */
+    void setTickInterval(int tickMs);
+
+    /**
+     * @brief Fire work after delayMs, on the GUI thread or on the pool at priority.
+     * @return Timer id for cancel(), or 0 after shutdown().
+     */
+    quint64 add(int delayMs, std::function<void()> work, bool onMainThread, int priority);
+    /**
+     * @brief Remove a timer that has not fired yet.
+     * @return false if it already fired, was cancelled or is unknown.
+     */
+    bool cancel(quint64 timerId);
+
+    Stats getStats() const;
+
+    /**
+     * @brief Stop the wheel thread; pending timers are discarded.
+     */
+    void shutdown();
+
+private:
+    static constexpr int LevelCount = 4;
+    static constexpr int SlotBits = 6;
+    static constexpr int SlotCount = 1 << SlotBits;
+
+    struct Timer {
+        quint64 id = 0;
+        quint64 deadlineTick = 0;
+        std::function<void()> work;
+        bool onMainThread = false;
+        int priority = 0;
+        int level = 0;
+        int slot = 0;
+        Timer* prev = nullptr;
+        Timer* next = nullptr;
+    };
+
+    quint64 currentTickLocked() const;
+    void insertLocked(Timer* timer);
+    void unlinkLocked(Timer* timer);
+    void cascadeLocked(int level, int slot);
+    void advanceLocked(quint64 nowTick, QList<Timer*>& expired);
+    int lowestOccupiedLevelLocked() const;
+    // Nanoseconds until the wheel next has work, or -1 if it is empty.
+    qint64 nextWakeNsLocked() const;
+    void fire(const QList<Timer*>& expired);
+    void run();
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeCondition;
+    QThread* m_thread;
+    bool m_stopping;
+
+    QElapsedTimer m_clock;
+    qint64 m_tickNs;
+    // Next tick to process; every timer's deadline is at or after it.
+    quint64 m_nextTick;
+    Timer* m_slots[LevelCount][SlotCount];
+    int m_levelCounts[LevelCount];
+    QHash<quint64, Timer*> m_timers;
+    quint64 m_nextTimerId;
+
+    quint64 m_firedCount;
+    quint64 m_cancelledCount;
+    quint64 m_firingTickCount;
+};
+
+#endif // INCLUDE_CORE_TIMERWHEEL_H
@@ -0,0 +1,51 @@
+#ifndef INCLUDE_RESOURCES_ASSETPACK_H
+#define INCLUDE_RESOURCES_ASSETPACK_H
+
+#include "resources/AssetPackFormat.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Read-only view over a memory-mapped asset pack file.
+ *
+ * The whole pack is mapped once in open(); lookups binary-search the on-disk
+ * index and read() returns a QByteArray that points straight into the mapping.
+ * Those byte arrays stay valid for as long as the AssetPack is alive.
+ */
+class AssetPack {
+public:
+    static constexpr const char* Protocol = "pack";
+
+    explicit AssetPack(const QString& filePath);
+    ~AssetPack();
+
+    bool open();
+    bool isOpen() const;
+    const QString& getFilePath() const;
+
+    QStringList getPaths() const;
+    bool contains(QStringView path) const;
+    QByteArray read(QStringView path) const;
+    AssetPackFormat::TypeHint getTypeHint(QStringView path) const;
+    quint64 getContentHash(QStringView path) const;
+
+private:
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    const AssetPackFormat::IndexEntry* findEntry(QStringView path) const;
+    QByteArrayView pathOf(const AssetPackFormat::IndexEntry& entry) const;
+
+    QString m_filePath;
+    QFile m_file;
+    const uchar* m_data;
+    qint64 m_dataSize;
+    const AssetPackFormat::IndexEntry* m_index;
+    quint32 m_entryCount;
+    qint64 m_stringsOffset;
+};
+
+#endif // INCLUDE_RESOURCES_ASSETPACK_H
@@ -0,0 +1,74 @@
+#ifndef INCLUDE_RESOURCES_ASSETPACKFORMAT_H
+#define INCLUDE_RESOURCES_ASSETPACKFORMAT_H
+
+#include <QByteArrayView>
+#include <QtEndian>
+#include <QtGlobal>
+
+/**
+ * @brief On-disk layout of an asset pack, shared by the runtime and the packer tool.
+ *
+ * A pack is a single file:
+ *   [Header][IndexEntry x entryCount][string table][payloads...]
+ *
+ * - Index entries are sorted by pathHash so lookups are a binary search.
+ * - Paths are UTF-8, relative to the packed directory, stored in the string table.
+ * - Every payload starts on a PayloadAlignment boundary so mapped bytes can be
+ *   handed to decoders without copying.
+ * - All integers are little-endian.
+ */
+namespace AssetPackFormat {
+
+constexpr char Magic[4] = { 'G', 'P', 'A', 'K' };
+constexpr quint32 Version = 1;
+constexpr qint64 PayloadAlignment = 64;
+
+enum class TypeHint : quint32 {
+    Unknown = 0,
+    Image = 1,
+    Json = 2,
+    Qml = 3,
+    Media = 4
+};
+
+struct Header {
+    char magic[4];
+    quint32_le version;
+    quint32_le entryCount;
+    quint32_le reserved;
+    quint64_le indexOffset;
+    quint64_le stringsOffset;
+};
+static_assert(sizeof(Header) == 32, "AssetPack header layout changed");
+
+struct IndexEntry {
+    quint64_le pathHash;
+    quint32_le pathOffset;
+    quint32_le pathLength;
+    quint64_le dataOffset;
+    quint64_le dataSize;
+    quint64_le contentHash;
+    quint32_le typeHint;
+    quint32_le reserved;
+};
+static_assert(sizeof(IndexEntry) == 48, "AssetPack index entry layout changed");
+
+/**
+ * @brief 64-bit FNV-1a; stable across processes (unlike qHash) so it can live on disk.
+ */
+inline quint64 hash(QByteArrayView data) {
+    quint64 value = 14695981039346656037ULL;
+    for (const char byte : data) {
+        value ^= static_cast<quint8>(byte);
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+constexpr qint64 alignUp(qint64 offset) {
+    return (offset + PayloadAlignment - 1) / PayloadAlignment * PayloadAlignment;
+}
+
+} // namespace AssetPackFormat
+
+#endif // INCLUDE_RESOURCES_ASSETPACKFORMAT_H
@@ -0,0 +1,63 @@
+#ifndef INCLUDE_RESOURCES_DECODEDIMAGECACHE_H
+#define INCLUDE_RESOURCES_DECODEDIMAGECACHE_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+
+/**
+ * @brief Optional on-disk cache of decoded, premultiplied pixel buffers.
+ *
+ * Entries are keyed by source content hash, source modification time and
+ * decode bounds, so an edited or re-scaled source never hits a stale entry.
+ * Hits are memory-mapped and wrapped in a QImage without copying; the mapping
+ * is released when the last QImage copy goes away.
+ *
+ * The cache directory and size cap come from Configuration.  The cap is
+ * enforced at startup by trimming least-recently-used files (hits refresh a
+ * file's modification time) and at runtime by not writing past it.
+ */
+class DecodedImageCache {
+public:
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 writes = 0;
+        qint64 bytesSaved = 0;
+        qint64 diskBytes = 0;
+        qint64 capBytes = 0;
+    };
+
+    static DecodedImageCache& getInstance();
+
+    void initialize();
+    bool isEnabled() const;
+
+    QString makeKey(const QByteArray& sourceBytes, qint64 sourceModifiedMs, const QSize& bounds) const;
+    QImage load(const QString& key);
+    void store(const QString& key, const QImage& image);
+
+    Stats getStats() const;
+
+private:
+    DecodedImageCache();
+    ~DecodedImageCache() = default;
+    DecodedImageCache(const DecodedImageCache&) = delete;
+    DecodedImageCache& operator=(const DecodedImageCache&) = delete;
+
+    void trimToCap();
+    QString filePathForKey(const QString& key) const;
+
+    mutable QMutex m_mutex;
+    QString m_directory;
+    qint64 m_capBytes;
+    qint64 m_diskBytes;
+    quint64 m_hits;
+    quint64 m_misses;
+    quint64 m_writes;
+    qint64 m_bytesSaved;
+};
+
+#endif // INCLUDE_RESOURCES_DECODEDIMAGECACHE_H
@@ -3,6 +3,8 @@
 
 #include "resources/Resource.h"
 
+#include <QJsonDocument>
+
 class JsonResource : public Resource {
 public:
     explicit JsonResource(const QString& url);
@@ -11,8 +13,12 @@ public:
     size_t getSize() const override;
     void setDataSize(size_t dataSize);
 
+    QJsonDocument getDocument() const;
+    void setDocument(const QJsonDocument& document);
+
 private:
     size_t m_dataSize;
+    QJsonDocument m_document;
 };
 
 #endif // INCLUDE_RESOURCES_JSONRESOURCE_H
@@ -0,0 +1,84 @@
+#ifndef INCLUDE_RESOURCES_LOADGROUP_H
+#define INCLUDE_RESOURCES_LOADGROUP_H
+
+#include "core/CancellationToken.h"
+#include "core/Execution.h"
+
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+class Loader;
+class Resources;
+
+/**
+ * @brief Loads a set of named resources as one unit.
+ *
+ * Created through Resources::createLoadGroup().  start() fans every resource
+ * out to the thread pool; completions are counted on the worker threads and
+ * only coalesced progress updates plus one final result reach the group's
+ * thread, instead of one wakeup per resource.
+ *
+ * Byte progress is measured in source bytes (file or pack entry sizes), which
+ * are known before anything is decoded, so the totals never change mid-load.
+ * The first failure finishes the group and cancels whatever is still pending.
+ */
+class LoadGroup : public QObject, public QEnableSharedFromThis<LoadGroup> {
+    Q_OBJECT
+public:
+    struct Progress {
+        int loadedCount = 0;
+        int totalCount = 0;
+        qint64 loadedBytes = 0;
+        qint64 totalBytes = 0;
+    };
+
+    ~LoadGroup() override = default;
+
+    void start();
+    void cancel();
+
+    /**
+     * @brief Current progress; thread-safe and cheap enough to poll every frame.
+     */
+    Progress getProgress() const;
+    bool isFinished() const;
+
+signals:
+    void progressChanged(int loadedCount, int totalCount, qint64 loadedBytes, qint64 totalBytes);
+    void finished(bool success, const QString& error);
+
+private:
+    friend class Resources;
+
+    // Pending loads keep the group alive through shared pointers, so it must be
+    // owned by one; Resources::createLoadGroup() takes care of that.
+    LoadGroup(const QStringList& names, Execution::Priority priority);
+
+    struct Item {
+        QString name;
+        QSharedPointer<Loader> loader;
+        qint64 bytes = 0;
+    };
+
+    void completeItem(int index, bool loaded);
+    void publishProgress();
+    void publishFinished();
+
+    const Execution::Priority m_priority;
+    QList<Item> m_items;
+    // Only touched on the group's thread (start/cancel/publishFinished).
+    QList<CancellationToken> m_tokens;
+    bool m_started;
+
+    mutable QMutex m_mutex;
+    Progress m_progress;
+    bool m_finished;
+    bool m_progressPending;
+    QString m_error;
+};
+
+#endif // INCLUDE_RESOURCES_LOADGROUP_H
@@ -1,15 +1,23 @@
 #ifndef LOADER_H
 #define LOADER_H
 
+#include "core/AsyncTask.h"
+#include "core/CancellationToken.h"
+#include "core/Execution.h"
+
 #include <QObject>
+#include <QFuture>
 #include <QHash>
 #include <QList>
 #include <QMutex>
+#include <QSet>
 #include <QSharedPointer>
+#include <QSize>
 #include <QString>
 #include <QVariant>
 
-class QMediaPlayer;
+#include <functional>
+
 class Resource;
 
 class Loader : public QObject {
@@ -23,12 +31,78 @@ public:
     void setSourceUrl(const QString& sourceUrl);
     QString getSourceUrl() const;
     bool isInitialized() const;
-
-    Loader& load(const QVariant& source = {}, bool async = true);
+    /**
+     * @brief ResourceCache key a load of source (or the configured source URL) uses.
+     */
+    QString getCacheKey(const QVariant& source = {}) const;
+
+    /**
+     * @brief Load source (or the configured source URL).
+     *
+     * Async loads are queued on Execution at the given priority.  Joining a
+     * load that is still queued raises it to the more urgent of the two
+     * priorities; a synchronous load raises it to Immediate.
+     *
+     * @return Token for this request.  Cancelling it drops the load if it is
+     *         still queued, or lets loadImpl() stop early, once every caller
+     *         sharing the load has cancelled.  Cancelled loads emit neither
+     *         loadFinished nor loadFailed.
+     */
+    CancellationToken load(const QVariant& source = {}, bool async = true,
+                           Execution::Priority priority = Execution::Priority::Visible);
+    /**
+     * @brief Start (or join) an async load without per-load completion signals.
+     *
+     * The result is recorded on the loader from whichever thread finishes the
+     * load, and the returned future resolves there too; no loadFinished or
+     * loadFailed is emitted.  Used to batch many loads (see LoadGroup).
+     * @param token Out: this caller's token, as returned by load().
+     */
+    QFuture<QSharedPointer<Resource>> requestLoad(const QVariant& source, Execution::Priority priority,
+                                                  CancellationToken& token);
+    /**
+     * @brief Load (or join a pending load of) source on the calling thread and return the result.
+     *
+     * Like requestLoad(), no loadFinished or loadFailed is emitted.  Unlike
+     * load(..., false) followed by getCachedResource(), the result cannot be
+     * lost to a cache eviction in between.
+     * @return The resource, or null on failure or cancellation.
+     */
+    QSharedPointer<Resource> loadSync(const QVariant& source = {});
+    /**
+     * @brief Awaitable form of requestLoad() for AsyncTask coroutines.
+     *
+     * co_await yields the resource (null on failure or cancellation) on the
+     * GUI thread.  Start several before awaiting them, e.g. with whenAll(),
+     * to load them in parallel.  A resource already in ResourceCache is
+     * returned without suspending.
+     */
+    AsyncTask<QSharedPointer<Resource>> loadAsync(QVariant source = {},
+                                                  Execution::Priority priority = Execution::Priority::Visible);
+    /**
+     * @brief Raise a still-queued load of source to priority.
+     * @return false if nothing is queued for source (not started, running or done).
+     */
+    bool raisePriority(Execution::Priority priority, const QVariant& source = {});
+    /**
+     * @brief Re-read the configured source after it changed on disk.
+     *
+     * Drops this loader's cache entries and runs loadImpl() again
+     * asynchronously.  Until the new payload is recorded,
+     * getCachedResource() keeps returning the previous one; if the reload fails the previous payload is
+     * cached again, so consumers only ever see one complete version.
+     * @return Token for the reload, or an invalid token if nothing was loaded yet.
+     */
+    CancellationToken reload(Execution::Priority priority = Execution::Priority::Visible);
     Loader& unload(bool async = true);
-    QObject* get() const;
 
-    virtual QSharedPointer<Resource> loadImpl(const QString& sourceUrl) = 0;
+    /**
+     * @brief Produce the resource for sourceUrl on a worker (or the caller for sync loads).
+     *
+     * Implementations should poll token between expensive steps and return
+     * null once it is cancelled.
+     */
+    virtual QSharedPointer<Resource> loadImpl(const QString& sourceUrl, const CancellationToken& token) = 0;
     virtual void unloadImpl();
 
     QSharedPointer<Resource> getCachedResource() const;
@@ -40,20 +114,47 @@ signals:
     void loadFailed(const QString& error);
 
 protected:
+    /**
+     * @brief Key under which a load of sourceUrl is cached and coalesced.
+     *
+     * Loaders whose output depends on more than the URL (e.g. decode size)
+     * override this so different variants do not collide.
+     */
+    virtual QString cacheKey(const QString& sourceUrl) const;
+    /**
+     * @brief Optionally split an async load into the stages of a TaskGraph.
+     *
+     * The stages then run as graph tasks, each released onto the worker
+     * that finished the one before, instead of one loadImpl() task.  Add
+     * them to graph, set result to read the outcome (null on failure) once
+     * the returned last stage has finished, and return that stage.  The
+     * default adds nothing and returns -1; synchronous loads always use
+     * loadImpl().
+     */
+    virtual TaskGraph::Node buildLoadGraph(TaskGraph& graph, const QString& sourceUrl, const CancellationToken& token,
+                                           std::function<QSharedPointer<Resource>()>& result);
+
     void markInitialized();
-    void cacheResource(const QString& sourceUrl, const QSharedPointer<Resource>& resource);
+    void cacheResource(const QString& key, const QSharedPointer<Resource>& resource);
     QSharedPointer<Resource> findCachedResource(const QString& sourceUrl) const;
     void setGeneratedLoaders(const QList<QSharedPointer<Loader>>& loaders);
 
 private:
+    QFuture<QSharedPointer<Resource>> startLoad(const QString& sourceUrl, const QString& key, bool async,
+                                                Execution::Priority priority, CancellationToken& token);
+    void recordLoad(const QString& key, const QSharedPointer<Resource>& resource);
+    void completeLoad(const QString& sourceUrl, const QString& key, const QSharedPointer<Resource>& resource);
+
     QString m_protocol;
     QString m_suffix;
     QString m_sourceUrl;
     bool m_initialized;
     mutable QMutex m_initializedMutex;
     mutable QMutex m_resourceMutex;
-    QHash<QString, QSharedPointer<Resource>> m_resourceCache;
-    QSharedPointer<Resource> m_lastResource;
+    // Payloads live in the shared ResourceCache; the loader only remembers its keys
+    // and holds the last result weakly so the cache budget stays authoritative.
+    QSet<QString> m_cachedUrls;
+    QWeakPointer<Resource> m_lastResource;
     QList<QSharedPointer<Loader>> m_generatedLoaders;
 };
 
@@ -61,31 +162,71 @@ class BitmapLoader : public Loader {
     Q_OBJECT
 public:
     explicit BitmapLoader(QObject* parent = nullptr);
-    QSharedPointer<Resource> loadImpl(const QString& sourceUrl) override;
+    QSharedPointer<Resource> loadImpl(const QString& sourceUrl, const CancellationToken& token) override;
+
+    /**
+     * @brief Bounds the image is decoded to fit in (aspect preserved, never upscaled).
+     *
+     * Defaults to the configured window size; an invalid size decodes at full
+     * source resolution.  Set it before calling load().
+     */
+    QSize getTargetSize() const;
+    void setTargetSize(const QSize& targetSize);
+
+protected:
+    QString cacheKey(const QString& sourceUrl) const override;
+    /**
+     * @brief Read (or find cached), decode and convert as three graph stages.
+     */
+    TaskGraph::Node buildLoadGraph(TaskGraph& graph, const QString& sourceUrl, const CancellationToken& token,
+                                   std::function<QSharedPointer<Resource>()>& result) override;
+
+private:
+    struct Load;
+
+    QSharedPointer<Resource> findLargerVariant(const QString& sourceUrl, const QSize& bounds) const;
+    void readStage(Load& load, const CancellationToken& token) const;
+    static void decodeStage(Load& load, const CancellationToken& token);
+    static void convertStage(Load& load, const CancellationToken& token);
+
+    mutable QMutex m_targetSizeMutex;
+    QSize m_targetSize;
 };
 
 class VideoLoader : public Loader {
     Q_OBJECT
 public:
     explicit VideoLoader(QObject* parent = nullptr);
-    QSharedPointer<Resource> loadImpl(const QString& sourceUrl) override;
-
-private:
-    QMediaPlayer* m_mediaPlayer;
+    QSharedPointer<Resource> loadImpl(const QString& sourceUrl, const CancellationToken& token) override;
 };
 
 class JsonLoader : public Loader {
     Q_OBJECT
 public:
     explicit JsonLoader(QObject* parent = nullptr);
-    QSharedPointer<Resource> loadImpl(const QString& sourceUrl) override;
+    QSharedPointer<Resource> loadImpl(const QString& sourceUrl, const CancellationToken& token) override;
+};
+
+/**
+ * @brief Loads a .soundbank file: JSON {"clips": {"name": "path", ...}}.
+ *
+ * Clip paths are relative to the bank file unless they carry a protocol.
+ * Every clip is decoded on the loading worker into SoundEffects' output
+ * format; clips longer than audio.sound_bank_max_clip_ms are skipped, as
+ * they belong in a streamed AudioItem instead.
+ */
+class SoundBankLoader : public Loader {
+    Q_OBJECT
+public:
+    explicit SoundBankLoader(QObject* parent = nullptr);
+    QSharedPointer<Resource> loadImpl(const QString& sourceUrl, const CancellationToken& token) override;
 };
 
 class QmlLoader : public Loader {
     Q_OBJECT
 public:
     explicit QmlLoader(QObject* parent = nullptr);
-    QSharedPointer<Resource> loadImpl(const QString& sourceUrl) override;
+    QSharedPointer<Resource> loadImpl(const QString& sourceUrl, const CancellationToken& token) override;
 };
 
 Q_DECLARE_METATYPE(QSharedPointer<Loader>)
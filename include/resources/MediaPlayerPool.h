@@ -0,0 +1,82 @@
+#ifndef INCLUDE_RESOURCES_MEDIAPLAYERPOOL_H
+#define INCLUDE_RESOURCES_MEDIAPLAYERPOOL_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QUrl>
+
+class QMediaPlayer;
+
+/**
+ * @brief Bounded pool of QMediaPlayer instances shared by playable items.
+ *
+ * Creating a player initialises the multimedia backend, so players are made
+ * on demand (or ahead of time by prewarm(), e.g. while a loading screen is
+ * up) and reused afterwards.  At most media.player_pool_size players exist;
+ * acquire() returns null once all of them are checked out.
+ *
+ * Each player comes with its own audio output.  Video output is left to
+ * whoever displays the player.
+ *
+ * GUI thread only.
+ */
+class MediaPlayerPool : public QObject {
+    Q_OBJECT
+public:
+    struct Stats {
+        int created = 0;
+        int idle = 0;
+        quint64 checkouts = 0;
+        quint64 exhausted = 0;
+    };
+
+    static MediaPlayerPool& getInstance();
+
+    void initialize();
+
+    /**
+     * @brief Check out an idle player, creating one if the pool is not full yet.
+     * @return null when every player is in use.
+     */
+    QMediaPlayer* acquire();
+    /**
+     * @brief Stop player, clear its source and make it available again.
+     *
+     * The borrower must drop its own connections to player first.
+     */
+    void release(QMediaPlayer* player);
+
+    /**
+     * @brief Create players up to the pool size so later acquires are cheap.
+     */
+    void prewarm();
+    /**
+     * @brief Destroy every player; checked-out players become dangling.
+     */
+    void clear();
+
+    Stats getStats() const;
+
+    /**
+     * @brief URL the multimedia backend can open for a path or qrc URL.
+     */
+    static QUrl toMediaUrl(const QString& path);
+
+private:
+    MediaPlayerPool();
+    ~MediaPlayerPool() override = default;
+    MediaPlayerPool(const MediaPlayerPool&) = delete;
+    MediaPlayerPool& operator=(const MediaPlayerPool&) = delete;
+
+    QMediaPlayer* createPlayer();
+
+    int m_capacity;
+    QList<QMediaPlayer*> m_players;
+    QList<QMediaPlayer*> m_idlePlayers;
+    int m_createdCount;
+    quint64 m_checkouts;
+    quint64 m_exhausted;
+};
+
+#endif // INCLUDE_RESOURCES_MEDIAPLAYERPOOL_H
@@ -3,16 +3,23 @@
 
 #include "resources/Resource.h"
 
+#include <QByteArray>
+
 class QmlResource : public Resource {
 public:
     explicit QmlResource(const QString& url);
     ~QmlResource() override = default;
 
     size_t getSize() const override;
-    void setDataSize(size_t dataSize);
+
+    /**
+     * @brief Raw QML source bytes (may point into a mapped asset pack).
+     */
+    QByteArray getData() const;
+    void setData(const QByteArray& data);
 
 private:
-    size_t m_dataSize;
+    QByteArray m_data;
 };
 
 #endif // INCLUDE_RESOURCES_QMLRESOURCE_H
@@ -69,13 +69,9 @@ public:
      */
     void setState(State state);
 
-    QObject* get() const;
-    void set(QObject* object);
-
 protected:
     QString m_url;
     State m_state;
-    QSharedPointer<QObject> m_object;
     mutable QReadWriteLock m_lock;
 };
 
@@ -0,0 +1,196 @@
+#ifndef INCLUDE_RESOURCES_RESOURCECACHE_H
+#define INCLUDE_RESOURCES_RESOURCECACHE_H
+
+#include "core/CancellationToken.h"
+
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QTimer>
+
+class Resource;
+
+/**
+ * @brief Process-wide byte-budgeted LRU cache shared by every Loader.
+ *
+ * Entries are accounted with Resource::getSize().  When an insert pushes the
+ * total above the budget, least-recently-used entries are evicted until the
+ * cache fits again.  Entries of held resources (see below; for example
+ * resources currently on screen) are never evicted; the cache may temporarily
+ * exceed its budget when only those remain.
+ *
+ * The cache also tracks loads that are still decoding so that concurrent
+ * requests for the same key share one decode instead of racing.
+ *
+ * Scene items hold ResourceHandles on the resources they use; the cache
+ * counts them per resource URL.  Entries of a resource with no holders are
+ * evicted once they have been idle (neither looked up nor held) for
+ * resources.idle_grace_s.  The sweep runs periodically on a worker.
+ *
+ * All methods are thread-safe; loaders call into the cache from worker threads.
+ */
+class ResourceCache {
+public:
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 evictions = 0;
+        qint64 usedBytes = 0;
+        qint64 budgetBytes = 0;
+        int entryCount = 0;
+        quint64 coalescedLoads = 0;
+        quint64 cancelledLoads = 0;
+        quint64 idleEvictions = 0;
+        int heldResources = 0;
+    };
+
+    static ResourceCache& getInstance();
+
+    void initialize();
+
+    QSharedPointer<Resource> find(const QString& key);
+    // True when key is cached or still loading; touches neither recency nor stats.
+    bool contains(const QString& key) const;
+    /**
+     * @brief Cache resource under key.
+     *
+     * Inserting the resource already cached under key only refreshes its
+     * recency.  A prefetch entry stays one until a non-prefetch insert or a
+     * find() claims it.
+     */
+    void insert(const QString& key, const QSharedPointer<Resource>& resource, bool prefetch = false);
+    void remove(const QString& key);
+    void clear();
+
+    /**
+     * @brief Drop unheld prefetch entries that were never looked up after being inserted.
+     *
+     * These are speculative loads (story prefetch) nobody has asked for yet;
+     * other entries are left alone even when nothing holds them.
+     * @return Bytes released from the cache's accounting.
+     */
+    qint64 releaseUnused();
+    /**
+     * @brief Drop texture entries no ResourceHandle holds; they are decoded again on next use.
+     *
+     * Textures of scene items hold a ResourceHandle, so what is on screen stays.
+     * @return Bytes released from the cache's accounting.
+     */
+    qint64 releaseTextures();
+
+    /**
+     * @brief Count a holder of the resource at url (see ResourceHandle).
+     */
+    void retain(const QString& url);
+    void release(const QString& url);
+    int getHolderCount(const QString& url) const;
+    /**
+     * @brief Evict unheld entries idle for longer than the grace period.
+     * @return Number of entries evicted.
+     */
+    int evictIdle();
+
+    /**
+     * @brief Join an in-flight load for key, or register future as the in-flight load.
+     * @param future In: the caller's future. Out: the in-flight future when coalesced.
+     * @param token In: the caller's fresh token. Out: a joined token when coalesced.
+     * @param prefetch Whether the caller is a speculative (Priority::Prefetch) load.
+     * @return true when another load was already pending and future now refers to it.
+     *
+     * A pending load whose holders have all cancelled is never joined; the
+     * caller's load replaces it.  A load stays a prefetch only while every
+     * caller that joined it is one.
+     */
+    bool attachPendingLoad(const QString& key, QFuture<QSharedPointer<Resource>>& future,
+                           CancellationToken& token, bool prefetch = false);
+    /**
+     * @brief Drop the pending entry for key if it still belongs to token's load.
+     */
+    void finishPendingLoad(const QString& key, const CancellationToken& token);
+    /**
+     * @brief Cache resource under key and drop token's pending entry, atomically.
+     *
+     * The entry is a prefetch entry when the pending load still is one.
+     */
+    void publishPendingLoad(const QString& key, const CancellationToken& token,
+                            const QSharedPointer<Resource>& resource);
+    void recordCancelledLoad();
+
+    /**
+     * @brief Execution task id running the pending load for key (0 if none/unknown).
+     *
+     * Lets a caller that joins a queued load raise its priority.
+     */
+    void setPendingTaskId(const QString& key, quint64 taskId);
+    quint64 getPendingTaskId(const QString& key) const;
+
+    qint64 getBudgetBytes() const;
+    void setBudgetBytes(qint64 budgetBytes);
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        QSharedPointer<Resource> resource;
+        qint64 size = 0;
+        quint64 useTick = 0;
+        bool used = false;
+        // Inserted by a speculative load only; see releaseUnused().
+        bool prefetch = false;
+        // Resource::getUrl(), the key holders are counted by.
+        QString sourceUrl;
+        qint64 lastUsedMs = 0;
+    };
+
+    struct PendingLoad {
+        QFuture<QSharedPointer<Resource>> future;
+        CancellationToken token;
+        quint64 taskId = 0;
+        bool prefetch = false;
+    };
+
+    ResourceCache();
+    ~ResourceCache() = default;
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    void touchLocked(const QString& key, Entry& entry);
+    void insertLocked(const QString& key, const QSharedPointer<Resource>& resource, bool prefetch);
+    void finishPendingLoadLocked(const QString& key, const CancellationToken& token);
+    void removeLocked(const QString& key);
+    void releaseLocked(const Entry& entry);
+    // Not held by a ResourceHandle.
+    bool isEvictableLocked(const Entry& entry) const;
+    void evictLocked();
+    template <typename Predicate>
+    qint64 releaseEvictableLocked(Predicate shouldRelease);
+
+    mutable QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    // Recency order: smallest tick is the least recently used key.
+    QMap<quint64, QString> m_lru;
+    QHash<QString, PendingLoad> m_pendingLoads;
+    // Number of keys referencing each payload, so aliases are accounted once.
+    QHash<const Resource*, int> m_keyCounts;
+    quint64 m_nextTick;
+    qint64 m_budgetBytes;
+    qint64 m_usedBytes;
+    quint64 m_hits;
+    quint64 m_misses;
+    quint64 m_evictions;
+    quint64 m_coalescedLoads;
+    quint64 m_cancelledLoads;
+    // url -> live ResourceHandle count; url -> when its last holder let go.
+    QHash<QString, int> m_holderCounts;
+    QHash<QString, qint64> m_releasedAtMs;
+    QElapsedTimer m_clock;
+    qint64 m_idleGraceMs;
+    QTimer m_idleSweepTimer;
+    quint64 m_idleEvictions;
+};
+
+#endif // INCLUDE_RESOURCES_RESOURCECACHE_H
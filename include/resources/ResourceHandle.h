@@ -0,0 +1,41 @@
+#ifndef INCLUDE_RESOURCES_RESOURCEHANDLE_H
+#define INCLUDE_RESOURCES_RESOURCEHANDLE_H
+
+#include <QString>
+
+/**
+ * @brief Counted reference from a scene item to the resource it displays or plays.
+ *
+ * A handle does not load anything or own the payload; it only tells
+ * ResourceCache that the resource is in use.  Cache entries for a resource
+ * with no handles are evicted once they have been idle for the configured
+ * grace period (resources.idle_grace_s), so short back-and-forth scene
+ * switches still hit the cache.
+ *
+ * Copies share the count; destroying or reset()ting a handle releases it.
+ */
+class ResourceHandle {
+public:
+    ResourceHandle() = default;
+    /**
+     * @param source Registered resource name or resource URL.
+     */
+    explicit ResourceHandle(const QString& source);
+    ResourceHandle(const ResourceHandle& other);
+    ResourceHandle& operator=(const ResourceHandle& other);
+    ResourceHandle(ResourceHandle&& other) noexcept;
+    ResourceHandle& operator=(ResourceHandle&& other) noexcept;
+    ~ResourceHandle();
+
+    bool isValid() const;
+    /**
+     * @brief URL of the held resource, the key ResourceCache counts holders by.
+     */
+    const QString& getUrl() const;
+    void reset();
+
+private:
+    QString m_url;
+};
+
+#endif // INCLUDE_RESOURCES_RESOURCEHANDLE_H
@@ -0,0 +1,24 @@
+#ifndef INCLUDE_RESOURCES_RESOURCEIMAGEPROVIDER_H
+#define INCLUDE_RESOURCES_RESOURCEIMAGEPROVIDER_H
+
+#include <QQuickImageProvider>
+
+/**
+ * @brief Serves decoded textures from ResourceCache to QML as "image://resources/<name>".
+ *
+ * Requests go through the resource's loader synchronously (QML calls providers
+ * off the GUI thread for asynchronous Images).  A cache hit hands QML the
+ * shared QImage without copying or re-decoding.  An Image's sourceSize is
+ * the decode bound, so thumbnails are decoded small rather than downscaled
+ * from a full-size texture.
+ */
+class ResourceImageProvider : public QQuickImageProvider {
+public:
+    static constexpr const char* ProviderId = "resources";
+
+    ResourceImageProvider();
+
+    QImage requestImage(const QString& id, QSize* size, const QSize& requestedSize) override;
+};
+
+#endif // INCLUDE_RESOURCES_RESOURCEIMAGEPROVIDER_H
@@ -0,0 +1,26 @@
+#ifndef INCLUDE_RESOURCES_RESOURCEMANIFESTFORMAT_H
+#define INCLUDE_RESOURCES_RESOURCEMANIFESTFORMAT_H
+
+/**
+ * @brief Text format of the build-time resource manifest.
+ *
+ * UTF-8, one line per asset after a header line:
+ *
+ *     GMAN 1
+ *     <url>\t<suffix>\t<size>\t<content hash, 16 hex digits>
+ *
+ * Content hashes use AssetPackFormat::hash(), the same function the packer
+ * stores per entry, so qrc and pack assets are directly comparable.  The
+ * manifest is embedded into the executable at ResourcePath.
+ */
+namespace ResourceManifestFormat {
+
+constexpr char Magic[] = "GMAN";
+constexpr int Version = 1;
+constexpr char FieldSeparator = '\t';
+constexpr int FieldCount = 4;
+constexpr char ResourcePath[] = ":/__manifest/resources.manifest";
+
+}
+
+#endif // INCLUDE_RESOURCES_RESOURCEMANIFESTFORMAT_H
@@ -0,0 +1,72 @@
+#ifndef INCLUDE_RESOURCES_RESOURCEWATCHER_H
+#define INCLUDE_RESOURCES_RESOURCEWATCHER_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+class QFileSystemWatcher;
+
+/**
+ * @brief Opt-in hot reload of file-backed resources.
+ *
+ * When resources.hot_reload is enabled, every registered resource whose URL
+ * resolves to a local file is watched.  Change notifications are debounced
+ * (editors often write a file in several steps), then only the loaders of
+ * the resources backed by that file are reloaded (see Loader::reload());
+ * nothing else in the caches is touched.  Loaders that were never created
+ * have nothing cached and are left alone.
+ *
+ * fileChanged() is emitted once per debounced change so that consumers with
+ * derived state (e.g. scenes built from a JSON file) can refresh it.
+ *
+ * Lives on the GUI thread; call every method from there.
+ */
+class ResourceWatcher : public QObject {
+    Q_OBJECT
+public:
+    static ResourceWatcher& getInstance();
+
+    /**
+     * @brief Start watching file resources if hot reload is enabled in Configuration.
+     */
+    void initialize();
+    bool isEnabled() const;
+
+    /**
+     * @brief Watch a resource registered after initialize().
+     * @return false if hot reload is off or name is not a local file resource.
+     */
+    bool watchResource(const QString& name);
+
+    int getWatchedFileCount() const;
+    quint64 getReloadCount() const;
+
+signals:
+    /**
+     * @brief A watched file changed and its live loaders were asked to reload.
+     * @param filePath Absolute path of the file.
+     */
+    void fileChanged(const QString& filePath);
+
+private:
+    ResourceWatcher();
+    ~ResourceWatcher() override = default;
+    ResourceWatcher(const ResourceWatcher&) = delete;
+    ResourceWatcher& operator=(const ResourceWatcher&) = delete;
+
+    void handleFileChanged(const QString& filePath);
+    void flushChanges();
+
+    QFileSystemWatcher* m_watcher;
+    QTimer m_debounceTimer;
+    // Absolute file path -> names of the resources it backs.
+    QHash<QString, QStringList> m_namesByPath;
+    QSet<QString> m_changedPaths;
+    quint64 m_reloadCount;
+};
+
+#endif // INCLUDE_RESOURCES_RESOURCEWATCHER_H
@@ -1,12 +1,21 @@
 #ifndef RESOURCES_H
 #define RESOURCES_H
 
+#include "core/Execution.h"
+
+#include <QByteArray>
 #include <QHash>
+#include <QList>
+#include <QMultiMap>
+#include <QMutex>
+#include <QSet>
 #include <QSharedPointer>
 #include <QString>
 #include <QStringList>
 #include <QVariant>
 
+class AssetPack;
+class LoadGroup;
 class Loader;
 
 class Resources {
@@ -15,9 +24,54 @@ public:
 
     void addResource(const QString& name, const QVariant& value);
 
+    /**
+     * @brief Loader for name, created on first use from its registration.
+     *
+     * Registration only records a descriptor, so startup cost and memory do not
+     * grow with the number of assets that are never loaded.  Thread-safe.
+     */
     QSharedPointer<Loader> getLoader(const QString& name) const;
+    /**
+     * @brief Whether name has a loader registered, without instantiating it.
+     */
+    bool hasLoader(const QString& name) const;
+    /**
+     * @brief Loader for name if it has already been created; never creates one.
+     */
+    QSharedPointer<Loader> findLoader(const QString& name) const;
+    int getRegisteredLoaderCount() const;
+    int getLiveLoaderCount() const;
     QVariant getResource(const QString& name) const;
     QStringList getResourceUrlsBySuffix(const QString& suffix) const;
+    QStringList getResourceNamesByProtocol(const QString& protocol) const;
+
+    /**
+     * @brief Names of resources whose path starts with pathPrefix, sorted by path.
+     *
+     * The path is the URL without its protocol ("qrc:/characters/A/smile.png"
+     * has path "characters/A/smile.png").  With suffixes given, only those
+     * suffixes are returned.  Runs in O(log n + result) per suffix.
+     */
+    QStringList findResourceNames(const QString& pathPrefix, const QStringList& suffixes = {}) const;
+
+    /**
+     * @brief Zero-copy bytes of a pack:// resource; valid for the process lifetime.
+     */
+    QByteArray readPackedResource(const QString& url) const;
+
+    /**
+     * @brief Size in bytes of the resource's source data (file or pack entry), or 0.
+     *
+     * Answered from the build-time manifest when it lists the resource, so it
+     * costs no filesystem access.
+     */
+    qint64 getSourceSize(const QString& name) const;
+
+    /**
+     * @brief Group the named resources into one batch load; call start() on the result.
+     */
+    QSharedPointer<LoadGroup> createLoadGroup(const QStringList& names,
+                                              Execution::Priority priority = Execution::Priority::Visible) const;
 
 private:
     Resources();
@@ -27,14 +81,41 @@ private:
 
     void registerDefaultLoaders();
     void registerResourcesFromQrc();
-    void resolveLoaderForResource(const QString& name, const QVariant& value);
+    void registerDevAssets();
+    bool loadManifest();
+    void registerAssetPacks();
+    void registerLoaderDescriptor(const QString& name, const QVariant& value);
+    QSharedPointer<Loader> createLoader(const QString& name, const QString& source) const;
     static QString normalizeResourcePath(const QString& value);
-    static bool resourceExists(const QString& value);
+    bool resourceExists(const QString& value) const;
+    const AssetPack* findAssetPack(const QString& url, QStringView& packPath) const;
     static QString extractProtocol(const QString& value);
     static QString extractSuffix(const QString& value);
+    static QString extractPath(const QString& value);
+    void indexResource(const QString& name, const QString& url);
+    void unindexResource(const QString& name, const QString& url);
+    static void appendRange(const QMultiMap<QString, QString>& index, const QString& pathPrefix, QStringList& names);
+
+    struct ManifestEntry {
+        qint64 size = 0;
+        quint64 contentHash = 0;
+    };
 
     QHash<QString, QVariant> m_resources;
-    QHash<QString, QSharedPointer<Loader>> m_resourceLoaders;
+    // Build-time listing of qrc (and packed) assets by URL; empty if the
+    // executable was built without one.
+    QHash<QString, ManifestEntry> m_manifest;
+    // Secondary indexes over string-valued resources, kept in step by addResource().
+    // Path-ordered maps (path -> name) turn prefix queries into range scans.
+    QMultiMap<QString, QString> m_pathIndex;
+    QHash<QString, QMultiMap<QString, QString>> m_suffixIndex;
+    QHash<QString, QSet<QString>> m_protocolIndex;
+    // name -> source URL for every loadable resource; loaders are built from it lazily.
+    mutable QMutex m_loaderMutex;
+    mutable QHash<QString, QString> m_loaderDescriptors;
+    mutable QHash<QString, QSharedPointer<Loader>> m_resourceLoaders;
+    // Mapped once at startup and never modified afterwards, so worker threads may read them.
+    QList<QSharedPointer<AssetPack>> m_assetPacks;
 };
 
 #endif // RESOURCES_H
@@ -0,0 +1,35 @@
+#ifndef INCLUDE_RESOURCES_SOUNDBANKRESOURCE_H
+#define INCLUDE_RESOURCES_SOUNDBANKRESOURCE_H
+
+#include "resources/Resource.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QStringList>
+
+/**
+ * @brief Short sound effects decoded to PCM in SoundEffects' output format.
+ *
+ * getSize() is the total PCM size of all clips, so the bank is accounted
+ * in ResourceCache like any other payload.
+ */
+class SoundBankResource : public Resource {
+public:
+    explicit SoundBankResource(const QString& url);
+    ~SoundBankResource() override = default;
+
+    size_t getSize() const override;
+
+    /**
+     * @brief PCM of the named clip (implicitly shared, no copy), or null.
+     */
+    QByteArray getClip(const QString& name) const;
+    QStringList getClipNames() const;
+    void addClip(const QString& name, const QByteArray& pcm);
+
+private:
+    QHash<QString, QByteArray> m_clips;
+    size_t m_pcmBytes;
+};
+
+#endif // INCLUDE_RESOURCES_SOUNDBANKRESOURCE_H
@@ -0,0 +1,103 @@
+#ifndef INCLUDE_RESOURCES_SOUNDEFFECTS_H
+#define INCLUDE_RESOURCES_SOUNDEFFECTS_H
+
+#include <QAudioFormat>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QTimer>
+
+#include <atomic>
+
+class QAudioSink;
+class SoundBankResource;
+class SoundMixerDevice;
+
+/**
+ * @brief Low-latency playback of sound bank clips through one shared audio sink.
+ *
+ * Clips are already PCM in the sink's format (see SoundBankLoader), so
+ * play() only adds a voice to the mixer; the sink pulls the mix on its own
+ * schedule.  Up to audio.max_voices clips play at once; further triggers are
+ * dropped.
+ *
+ * The sink only runs while clips play: the first play() starts or resumes
+ * it, and once the mix has been silent for the sink buffer's duration it is
+ * suspended again, so an idle game does not wake the audio thread.  Without
+ * an output device play() always fails.
+ *
+ * Banks passed to loadBank() stay resident until unloadBank(); their PCM
+ * size is reported per bank by getBankBytes().
+ *
+ * play() may be called from any thread; everything else belongs to the GUI
+ * thread.  play() only touches the mixer, which lives as long as the
+ * instance; the sink is driven through queued calls and fails play() once it
+ * has been torn down on quit.
+ */
+class SoundEffects : public QObject {
+    Q_OBJECT
+public:
+    struct Stats {
+        quint64 triggers = 0;
+        quint64 dropped = 0;
+        // Trigger until the first frame of the clip is mixed into the sink.
+        qint64 averageLatencyUs = 0;
+        qint64 maxLatencyUs = 0;
+        // What the sink still buffers after that, from its buffer size.
+        qint64 sinkBufferUs = 0;
+        // Times the idle sink was started or resumed by play().
+        quint64 outputResumes = 0;
+    };
+
+    static SoundEffects& getInstance();
+
+    void initialize();
+
+    /**
+     * @brief Format clips must be decoded to; fixed by initialize().
+     */
+    QAudioFormat getFormat() const;
+
+    /**
+     * @brief Start loading a sound bank resource and keep it resident once loaded.
+     */
+    Q_INVOKABLE void loadBank(const QString& bankName);
+    Q_INVOKABLE void unloadBank(const QString& bankName);
+    /**
+     * @brief Play a clip from a loaded bank.
+     * @return false if the bank is not loaded, the clip is unknown or all voices are busy.
+     */
+    Q_INVOKABLE bool play(const QString& bankName, const QString& clipName, float volume = 1.0f);
+    Q_INVOKABLE qint64 getBankBytes(const QString& bankName) const;
+
+    Stats getStats() const;
+
+private:
+    SoundEffects();
+    ~SoundEffects() override = default;
+    SoundEffects(const SoundEffects&) = delete;
+    SoundEffects& operator=(const SoundEffects&) = delete;
+
+    void resumeOutput();
+    void scheduleIdleSuspend();
+    void suspendIdleOutput();
+    void stopOutput();
+
+    QAudioFormat m_format;
+    QAudioSink* m_sink;
+    SoundMixerDevice* m_mixer;
+    // Set while the sink runs; play() on any thread starts it on the transition.
+    std::atomic<bool> m_outputActive;
+    // Set while m_sink exists.  play() checks this instead of m_sink, which
+    // stopOutput() deletes on the GUI thread.
+    std::atomic<bool> m_outputAvailable;
+    QTimer m_idleTimer;
+    quint64 m_outputResumes;
+    // Bank name -> resident bank.  Written on the GUI thread, read by play().
+    mutable QMutex m_banksMutex;
+    QHash<QString, QSharedPointer<SoundBankResource>> m_banks;
+};
+
+#endif // INCLUDE_RESOURCES_SOUNDEFFECTS_H
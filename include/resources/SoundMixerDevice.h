@@ -0,0 +1,75 @@
+#ifndef INCLUDE_RESOURCES_SOUNDMIXERDEVICE_H
+#define INCLUDE_RESOURCES_SOUNDMIXERDEVICE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QList>
+#include <QMutex>
+
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Endless pull-mode source that mixes the active voices on demand.
+ *
+ * Voices are 16-bit PCM in the reader's format; reads return their sum,
+ * clamped, and silence when nothing plays.  The time from addVoice() until a
+ * read first mixes the voice is recorded as its trigger-to-mix latency.
+ *
+ * addVoice() may be called from any thread; reads come from the sink's thread.
+ */
+class SoundMixerDevice : public QIODevice {
+public:
+    struct Stats {
+        quint64 triggers = 0;
+        quint64 dropped = 0;
+        qint64 averageLatencyUs = 0;
+        qint64 maxLatencyUs = 0;
+    };
+
+    SoundMixerDevice(int maxVoices, QObject* parent = nullptr);
+
+    void setFrameBytes(qint64 frameBytes);
+    /**
+     * @brief Called from the reading thread when a read has mixed the last active voice to its end.
+     */
+    void setIdleCallback(std::function<void()> onIdle);
+
+    /**
+     * @return false if all voices are busy and the clip was dropped.
+     */
+    bool addVoice(const QByteArray& pcm, float volume);
+    int getVoiceCount() const;
+    Stats getStats() const;
+
+    bool isSequential() const override;
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    struct Voice {
+        QByteArray pcm;
+        qsizetype offset = 0;
+        float volume = 1.0f;
+        qint64 triggeredNs = 0;
+    };
+
+    mutable QMutex m_mutex;
+    QList<Voice> m_voices;
+    std::vector<qint32> m_accumulator;
+    QElapsedTimer m_clock;
+    int m_maxVoices;
+    qint64 m_frameBytes;
+    std::function<void()> m_onIdle;
+    quint64 m_triggers;
+    quint64 m_dropped;
+    quint64 m_latencySamples;
+    qint64 m_totalLatencyNs;
+    qint64 m_maxLatencyNs;
+};
+
+#endif // INCLUDE_RESOURCES_SOUNDMIXERDEVICE_H
@@ -3,6 +3,8 @@
 
 #include "resources/Resource.h"
 
+#include <QImage>
+
 class TextureResource : public Resource {
 public:
     explicit TextureResource(const QString& url);
@@ -14,9 +16,16 @@ public:
     int getHeight() const;
     void setDimensions(int width, int height);
 
+    /**
+     * @brief Decoded pixels; QImage is implicitly shared so callers get no copy.
+     */
+    QImage getImage() const;
+    void setImage(const QImage& image);
+
 private:
     int m_width;
     int m_height;
+    QImage m_image;
 };
 
 #endif // INCLUDE_RESOURCES_TEXTURERESOURCE_H
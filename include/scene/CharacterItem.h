@@ -1,6 +1,7 @@
 #ifndef INCLUDE_SCENE_CHARACTERITEM_H
 #define INCLUDE_SCENE_CHARACTERITEM_H
 
+#include "resources/ResourceHandle.h"
 #include "scene/Item.h"
 
 class CharacterItem : public Item {
@@ -16,10 +17,15 @@ public:
     void setVisible(bool visible);
     bool isVisible() const;
 
+    void initialize() override;
+    void cleanup() override;
+    QStringList getResourceSources() const override;
     QString getType() const override;
 
 private:
     QString m_portrait;
+    // Keeps the portrait's cache entries from idle eviction while the item exists.
+    ResourceHandle m_portraitHandle;
     QString m_expression;
     bool m_visible;
 };
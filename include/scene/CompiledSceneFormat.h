@@ -0,0 +1,46 @@
+#ifndef INCLUDE_SCENE_COMPILEDSCENEFORMAT_H
+#define INCLUDE_SCENE_COMPILEDSCENEFORMAT_H
+
+#include "resources/AssetPackFormat.h"
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QCborMap>
+#include <QCborValue>
+#include <QJsonObject>
+#include <QString>
+
+/**
+ * @brief Layout of a compiled (.cbor) scene, shared by Scene and qt-galgame-scenec.
+ *
+ * The source JSON object converted to CBOR, with one extra top-level key
+ * written first: SourceHashKey, the AssetPackFormat::hash() of the JSON
+ * bytes it was compiled from as 16 hex digits.  Scene only uses the compiled
+ * form while that hash still matches the JSON next to it; scenes embedded
+ * in the executable are compiled by the build together with their JSON and
+ * are not re-hashed.
+ */
+namespace CompiledSceneFormat {
+
+constexpr char SourceHashKey[] = "sourceHash";
+
+inline QByteArray sourceHash(QByteArrayView json) {
+    return QByteArray::number(AssetPackFormat::hash(json), 16).rightJustified(16, '0');
+}
+
+/**
+ * @brief The compiled form of root, parsed from json.
+ */
+inline QByteArray compile(const QJsonObject& root, QByteArrayView json) {
+    // The source hash goes first so Scene can check it without walking the scene.
+    QCborMap compiled;
+    compiled.insert(QLatin1String(SourceHashKey), QString::fromLatin1(sourceHash(json)));
+    for (auto it = root.begin(); it != root.end(); ++it) {
+        compiled.insert(it.key(), QCborValue::fromJsonValue(it.value()));
+    }
+    return QCborValue(compiled).toCbor();
+}
+
+}
+
+#endif // INCLUDE_SCENE_COMPILEDSCENEFORMAT_H
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QString>
 #include <QSharedPointer>
+#include <QStringList>
 
 /**
  * @brief Base class for all items that can be placed in a scene.
@@ -60,6 +61,22 @@ public:
      */
     virtual void fixedUpdate();
 
+    /**
+     * @brief Whether update()/fixedUpdate() must keep running every frame.
+     *
+     * While nothing in the active scene reports pending work the frame loop
+     * goes idle and stops calling them.  An item that starts needing frames
+     * again calls GameManager::requestFrame().
+     */
+    virtual bool hasPendingWork() const;
+
+    /**
+     * @brief Resource names or URLs the item displays or plays.
+     *
+     * GameManager loads them before initializing the item's scene.
+     */
+    virtual QStringList getResourceSources() const;
+
     /**
      * @brief Clean up resources when item is removed
      */
@@ -1,14 +1,21 @@
 #ifndef INCLUDE_SCENE_PLAYABLEITEM_H
 #define INCLUDE_SCENE_PLAYABLEITEM_H
 
+#include "resources/ResourceHandle.h"
 #include "scene/Item.h"
 
+#include <QMediaPlayer>
+
 /**
  * @brief Shared base for items that have a playable media source (audio or video).
  *
  * AudioItem and VideoItem inherit from this class and only need to override
  * getType().  All common state and signals live here so the two concrete
  * subclasses remain trivial.
+ *
+ * A QMediaPlayer is checked out of MediaPlayerPool by play() and returned by
+ * stop(), when playback reaches the end, or on cleanup(); player is null
+ * while the item is not playing.
  */
 class PlayableItem : public Item {
     Q_OBJECT
@@ -17,8 +24,10 @@ class PlayableItem : public Item {
     // playing is read-only from outside: callers drive it through play()/stop()
     // so that signal emission and state update stay consistent.
     Q_PROPERTY(bool playing READ isPlaying NOTIFY playingChanged)
+    Q_PROPERTY(QMediaPlayer* player READ getPlayer NOTIFY playerChanged)
 public:
     explicit PlayableItem(QObject* parent = nullptr);
+    ~PlayableItem() override;
 
     QString getSource() const;
     void setSource(const QString& source);
@@ -27,21 +36,35 @@ public:
     void setLoop(bool loop);
 
     bool isPlaying() const;
+    QMediaPlayer* getPlayer() const;
 
     Q_INVOKABLE void play();
     Q_INVOKABLE void stop();
 
+    void initialize() override;
+    void cleanup() override;
+    QStringList getResourceSources() const override;
+
 signals:
     void sourceChanged();
     void loopChanged();
     void playingChanged();
+    void playerChanged();
     void playRequested();
     void stopRequested();
 
+private:
+    void releasePlayer();
+    void handlePlaybackStateChanged(QMediaPlayer::PlaybackState state);
+
 protected:
     QString m_source;
+    // Keeps the source's cache entries from idle eviction while the item exists.
+    ResourceHandle m_sourceHandle;
     bool m_loop;
     bool m_playing;
+    QMediaPlayer* m_player;
+    QMetaObject::Connection m_playerConnection;
 };
 
 #endif // INCLUDE_SCENE_PLAYABLEITEM_H
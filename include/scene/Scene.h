@@ -2,11 +2,14 @@
 #define INCLUDE_SCENE_SCENE_H
 
 #include "Item.h"
+#include "factory/Factory.h"
 #include <QList>
 #include <QHash>
 #include <QSharedPointer>
 #include <QString>
 
+class QIODevice;
+
 /**
  * @brief Container for Items with support for loading from QML or JSON.
  * 
@@ -52,11 +55,43 @@ public:
 
     /**
      * @brief Load scene from a file; format is inferred from the URL suffix.
-     * @param url Path or qrc URL to a .json or .qml file
+     *
+     * For a .json scene, a compiled sibling with the same base name and a
+     * .cbor suffix (see qt-galgame-scenec) is preferred when present.  An
+     * embedded (qrc) one is built with its JSON and used as is; a loose one
+     * only while its recorded source hash matches the JSON, and a stale one
+     * is ignored with a warning.
+     * @param url Path or qrc URL to a .json, .cbor or .qml file
      * @return true if successful, false otherwise
      */
     bool load(const QString& url);
 
+    /**
+     * @brief URL passed to the last load(), or empty.
+     */
+    const QString& getSourceUrl() const;
+
+    /**
+     * @brief Parse the items of a scene JSON file without building them.
+     *
+     * Touches no scene state, so it may run on a worker thread; pair it with
+     * applyChangedItems() on the thread that owns the scene.
+     */
+    static bool readJsonItems(const QString& filePath, QList<PropertyMap>& items);
+
+    /**
+     * @brief Bring the scene in line with a re-read item list, matching items by id.
+     *
+     * Items whose properties are unchanged are kept as they are.  Changed items
+     * are rebuilt in place (same position in the update order), new ids are
+     * appended and ids no longer present are removed.  Items without an id
+     * cannot be matched: edits to them are skipped with a warning.  Rebuilt
+     * items are initialized if the scene is.  Only scenes loaded while hot
+     * reload (ResourceWatcher) is enabled keep the properties to compare.
+     * @return Number of items replaced, added or removed.
+     */
+    int applyChangedItems(const QList<PropertyMap>& items);
+
     /**
      * @brief Initialize all items in the scene
      */
@@ -74,6 +109,11 @@ public:
      */
     void fixedUpdate() override;
 
+    /**
+     * @brief True if any item in the scene has pending work
+     */
+    bool hasPendingWork() const override;
+
     /**
      * @brief Clear all items from the scene
      */
@@ -83,10 +123,19 @@ public:
 
 private:
     bool loadFromJson(const QString& filePath);
+    bool loadFromJsonStream(QIODevice& device, const QString& filePath);
+    bool loadFromCbor(const QString& filePath);
     bool loadFromQml(const QString& filePath);
+    void applySceneId(const QString& parsedId, const QString& filePath);
+    void createItem(PropertyMap& properties);
+    QSharedPointer<Item> instantiateItem(const PropertyMap& properties) const;
+    bool replaceItem(const QString& itemId, const PropertyMap& properties);
 
+    QString m_sourceUrl;
     QList<QSharedPointer<Item>> m_items;
     QHash<QString, QSharedPointer<Item>> m_itemMap;
+    // Properties each id'd item was built from, to tell changed items apart on reload.
+    QHash<QString, PropertyMap> m_itemProperties;
 };
 
 #endif // INCLUDE_SCENE_SCENE_H
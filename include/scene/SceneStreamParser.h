@@ -0,0 +1,59 @@
+#ifndef INCLUDE_SCENE_SCENESTREAMPARSER_H
+#define INCLUDE_SCENE_SCENESTREAMPARSER_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+class QIODevice;
+
+/**
+ * @brief Incremental reader for scene JSON ({"scene": {"id": ..., "items": [...]}}).
+ *
+ * The device is read in fixed-size chunks and scanned structurally; only the
+ * bytes of the item currently open are buffered.  Each element of
+ * scene.items is handed to the item callback as soon as its closing brace is
+ * seen, so peak memory is bounded by the largest single item rather than the
+ * file, and item creation interleaves with reading.
+ */
+class SceneStreamParser {
+public:
+    using SceneIdHandler = std::function<void(const QString&)>;
+    using ItemHandler = std::function<void(const QJsonObject&)>;
+
+    SceneStreamParser(SceneIdHandler onSceneId, ItemHandler onItem);
+
+    bool parse(QIODevice& device);
+    const QString& getErrorString() const;
+
+private:
+    struct Frame {
+        char type = '{';
+        QByteArray key;
+        bool expectKey = false;
+    };
+
+    bool feed(const char* data, qsizetype size);
+    bool openContainer(char type);
+    bool closeContainer(char type);
+    void finishString();
+    bool isItemsArray() const;
+    bool isSceneIdValue() const;
+    bool fail(const QString& error);
+
+    SceneIdHandler m_onSceneId;
+    ItemHandler m_onItem;
+    QList<Frame> m_stack;
+    bool m_inString;
+    bool m_escape;
+    bool m_stringIsKey;
+    QByteArray m_string;
+    bool m_inItem;
+    QByteArray m_itemBuffer;
+    QString m_errorString;
+};
+
+#endif // INCLUDE_SCENE_SCENESTREAMPARSER_H
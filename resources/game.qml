@@ -1,6 +1,7 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
+import QtMultimedia
 import Galgame 1.0
 
 Item {
@@ -240,6 +241,9 @@ Item {
     property bool fastForward:    false
     property bool hudVisible:     true
     readonly property int fastForwardIntervalMs: 600
+    readonly property string uiSoundBank: "qrc:/sfx/ui.soundbank"
+    // Loaded with the first shot; later shots only load their own steps.
+    readonly property var screenAssets: ["qrc:/images/ground.png", "qrc:/sfx/whoosh.wav", uiSoundBank]
 
     property var  visitedShots:   []
     readonly property var charMeta: gameConstants.charMeta !== undefined ? gameConstants.charMeta : ({
@@ -271,6 +275,7 @@ Item {
         if (inTransition) return
         const advanceResult = GameManager.advanceStory(storyData, visitedShots)
         if (advanceResult.advanced !== true) return
+        SoundEffects.play(uiSoundBank, "click")
         currentStep = advanceResult.nextStep
         visitedShots = advanceResult.visitedShots
         if (advanceResult.shotChanged === true) {
@@ -281,9 +286,12 @@ Item {
     }
 
     function doTransition(nextStepIdx, style) {
+        transitionSound.stop()
+        transitionSound.play()
         inTransition = true
         hudVisible   = false
         transitionTimer.nextStep = nextStepIdx
+        GameManager.loadShot(storyData, nextStepIdx)
         transitionTimer.style = style
         if (style === "slide_ltr") {
             transitionTimer.interval = gameConstants.sceneTransition !== undefined &&
@@ -299,7 +307,9 @@ Item {
     }
 
     Component.onCompleted: {
+        SoundEffects.loadBank(uiSoundBank)
         currentStep = GameManager.currentStoryStep
+        GameManager.loadShot(storyData, currentStep, screenAssets)
         // Record initial shot as visited
         if (storyData.length > 0) {
             visitedShots = [storyData[currentStep].shot]
@@ -307,6 +317,8 @@ Item {
         scheduleAutoAdvance()
     }
 
+    Component.onDestruction: SoundEffects.unloadBank(uiSoundBank)
+
     onCurrentStepChanged: scheduleAutoAdvance()
 
     // Fast-forward timer
@@ -371,6 +383,18 @@ Item {
         onFinished: transitionEndTimer.start()
     }
 
+    // Shot change stinger.  Its player is checked out of MediaPlayerPool,
+    // which GameManager.startGame() pre-warmed while this screen loaded.
+    AudioItem {
+        id: transitionSound
+        source: "qrc:/sfx/whoosh.wav"
+        onPlayRequested: {
+            if (player !== null) {
+                player.audioOutput.volume = Configuration.masterVolume
+            }
+        }
+    }
+
     // ── Background ────────────────────────────────────────────────────────
     Rectangle {
         id: background
@@ -380,6 +404,20 @@ Item {
                : "#87CEEB"
 
         Behavior on color { ColorAnimation { duration: 300 } }
+
+        // Served from ResourceCache; sourceSize makes the provider decode at
+        // the displayed size instead of the full texture.
+        Image {
+            anchors.left: parent.left
+            anchors.right: parent.right
+            anchors.bottom: parent.bottom
+            height: parent.height * 0.35
+            source: "image://resources/qrc:/images/ground.png"
+            sourceSize.width: width
+            sourceSize.height: height
+            fillMode: Image.Stretch
+            asynchronous: true
+        }
     }
 
     // ── Scene content (characters + shot title) ────────────────────────────
@@ -755,6 +793,25 @@ Item {
         Behavior on opacity { NumberAnimation { duration: 380 } }
     }
 
+    // ── Shot loading bar ──────────────────────────────────────────────────
+    Rectangle {
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.top: parent.top
+        height: 4
+        color: "#40000000"
+        visible: GameManager.loading
+        z: 100
+
+        Rectangle {
+            width: parent.width * GameManager.loadProgress
+            height: parent.height
+            color: "#E8C872"
+
+            Behavior on width { NumberAnimation { duration: 120 } }
+        }
+    }
+
     // ── Click-to-advance on scene area ────────────────────────────────────
     MouseArea {
         anchors.left: parent.left
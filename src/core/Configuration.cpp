@@ -41,15 +41,48 @@ void Configuration::setDefaults() {
     // Render defaults
     setTargetFPS(60);
     setVSyncEnabled(true);
+    setInt("render.image_decode_quality", 75);
+    setBool("render.on_demand", true);  // render only while the active scene has per-frame work
 
     // Execution defaults
     setInt("execution.max_threads", QThread::idealThreadCount());
+    setInt("execution.priority_aging_ms", 250);
+    setInt("execution.main_thread_budget_us", 2000);  // per-frame time for queued main-thread tasks
+    setInt("execution.timer_tick_ms", 4);  // timed-task resolution; deadlines within a tick fire together
+
+    // Resource defaults
+    setInt("resources.cache_budget_mb", 512);
+    setInt("resources.idle_grace_s", 120);  // unheld cache entries idle this long are evicted; 0 disables
+    setString("resources.asset_packs", QString());  // comma-separated pack file paths
+    setString("resources.image_disk_cache_dir", QString());  // empty disables the disk cache
+    setInt("resources.image_disk_cache_mb", 1024);
+    setBool("resources.hot_reload", false);  // watch file resources and reload them on change
+    setInt("resources.hot_reload_debounce_ms", 200);
+    setString("resources.dev_asset_dir", QString());  // loose files here override qrc entries with the same path
+
+    // Media defaults
+    setInt("media.player_pool_size", 2);  // players shared by all playing audio/video items
+    setInt("audio.sound_bank_max_clip_ms", 3000);  // longer clips are not decoded into sound banks
+    setInt("audio.max_voices", 16);
+
+    // Memory pressure defaults
+    setInt("memory.rss_threshold_mb", 2048);  // 0 disables RSS polling
+    setInt("memory.poll_interval_ms", 2000);
 
     // Application bootstrap defaults
     setApplicationName("qt-galgame-by-ai");
     setStartupSceneUrl("qrc:/main.qml");
     setGameLoopIntervalMs(16);  // ~60 FPS (1000ms / 60 ≈ 16.67ms)
 
+    // Story defaults
+    setInt("story.prefetch_shots", 2);
+
+    // Scene defaults
+    setInt("scene.streaming_threshold_kb", 1024);  // larger scene JSON is parsed incrementally
+
+    // Debug defaults
+    setInt("debug.idle_cpu_sample_ms", 0);  // >0: log process CPU over this window after startup, then quit
+
     // Game state defaults
     setOpeningAnimationPlayed(false);
     setConfigFilePath("galgame_config.json");
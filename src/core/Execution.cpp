@@ -2,8 +2,26 @@
 
 #include "core/Configuration.h"
 
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QMutexLocker>
+
+#include <utility>
+
 namespace {
 constexpr double NanosecondsToSeconds = 1e-9;
+constexpr qint64 NanosecondsPerMillisecond = 1000000;
+constexpr qint64 NanosecondsPerMicrosecond = 1000;
+constexpr int DefaultPriorityAgingMs = 250;
+constexpr int DefaultMainThreadBudgetUs = 2000;
+constexpr int DefaultTimerTickMs = 4;
+
+void drainMainThreadTasksFromEventLoop() {
+    if (Execution::getInstance().runMainThreadTasks() > 0) {
+        QMetaObject::invokeMethod(QCoreApplication::instance(), &drainMainThreadTasksFromEventLoop,
+                                  Qt::QueuedConnection);
+    }
+}
 }
 
 Execution::Execution()
@@ -16,6 +34,11 @@ Execution::Execution()
     , m_fps(0.0f)
     , m_fpsAccumulator(0.0f)
     , m_fpsFrameCount(0)
+    , m_frameClockSuspended(false)
+    , m_idleNs(0)
+    , m_mainThreadWakePending(false)
+    , m_mainThreadBudgetNs(DefaultMainThreadBudgetUs * NanosecondsPerMicrosecond)
+    , m_mainThreadTasksRunLastFrame(0)
 {
 }
 
@@ -34,15 +57,37 @@ void Execution::initialize() {
     m_fpsAccumulator = 0.0f;
     m_fpsFrameCount = 0;
     m_fixedUpdateAccumulator = 0.0f;
+    m_frameClockSuspended = false;
+    m_idleNs = 0;
 
     const int configuredMaxThreads = Configuration::getInstance()
         .getValue(QStringLiteral("execution.max_threads"), QThread::idealThreadCount())
         .toInt();
     setMaxThreadCount(configuredMaxThreads);
+
+    const int agingMs = Configuration::getInstance()
+        .getValue(QStringLiteral("execution.priority_aging_ms"), DefaultPriorityAgingMs)
+        .toInt();
+    m_scheduler.setAgingInterval(qMax(1, agingMs) * NanosecondsPerMillisecond);
+
+    m_timerWheel.setTickInterval(Configuration::getInstance()
+        .getValue(QStringLiteral("execution.timer_tick_ms"), DefaultTimerTickMs)
+        .toInt());
+
+    const int budgetUs = Configuration::getInstance()
+        .getValue(QStringLiteral("execution.main_thread_budget_us"), DefaultMainThreadBudgetUs)
+        .toInt();
+    QMutexLocker locker(&m_mainThreadMutex);
+    m_mainThreadBudgetNs = qMax(0, budgetUs) * NanosecondsPerMicrosecond;
 }
 
 void Execution::update() {
     const qint64 currentNs = m_runtimeTimer.nsecsElapsed();
+    if (m_frameClockSuspended) {
+        m_idleNs += currentNs - m_lastFrameNs;
+        m_lastFrameNs = currentNs;
+        m_frameClockSuspended = false;
+    }
     const qint64 elapsedNs = currentNs - m_lastFrameNs;
     m_deltaTime = static_cast<float>(elapsedNs * NanosecondsToSeconds);
     m_lastFrameNs = currentNs;
@@ -97,13 +142,109 @@ void Execution::reset() {
     initialize();
 }
 
+void Execution::suspendFrameClock() {
+    m_frameClockSuspended = true;
+}
+
+float Execution::getIdleTime() const {
+    return static_cast<float>(m_idleNs * NanosecondsToSeconds);
+}
+
 int Execution::getMaxThreadCount() const {
-    return m_threadPool.maxThreadCount();
+    return m_scheduler.getWorkerCount();
+}
+
+int Execution::getActiveThreadCount() const {
+    return m_scheduler.getActiveWorkerCount();
 }
 
 void Execution::setMaxThreadCount(int threadCount) {
-    if (threadCount <= 0) {
-        threadCount = 1;
+    m_scheduler.setWorkerCount(threadCount);
+}
+
+int Execution::getQueuedTaskCount(Priority priority) const {
+    return m_scheduler.getQueuedTaskCount(static_cast<int>(priority));
+}
+
+quint64 Execution::getDroppedTaskCount() const {
+    return m_scheduler.getDroppedTaskCount();
+}
+
+quint64 Execution::getStolenTaskCount() const {
+    return m_scheduler.getStolenTaskCount();
+}
+
+QFuture<void> Execution::runGraph(TaskGraph graph, Priority priority, const CancellationToken& token,
+                                  QList<quint64>* rootTaskIds) {
+    return m_scheduler.submitGraph(std::move(graph), static_cast<int>(priority), token, rootTaskIds);
+}
+
+int Execution::runMainThreadTasks() {
+    QElapsedTimer budgetTimer;
+    budgetTimer.start();
+    {
+        QMutexLocker locker(&m_mainThreadMutex);
+        // Anything queued from here on needs a wake-up of its own.
+        m_mainThreadWakePending = false;
+    }
+    int ran = 0;
+    while (true) {
+        std::function<void()> task;
+        {
+            QMutexLocker locker(&m_mainThreadMutex);
+            if (m_mainThreadTasks.isEmpty() || (ran > 0 && budgetTimer.nsecsElapsed() >= m_mainThreadBudgetNs)) {
+                m_mainThreadTasksRunLastFrame = ran;
+                return static_cast<int>(m_mainThreadTasks.size());
+            }
+            task = m_mainThreadTasks.takeFirst();
+        }
+        // Outside the lock: the task may queue further main-thread work.
+        task();
+        ++ran;
     }
-    m_threadPool.setMaxThreadCount(threadCount);
+}
+
+void Execution::setMainThreadWakeup(std::function<bool()> wakeup) {
+    QMutexLocker locker(&m_mainThreadMutex);
+    m_mainThreadWakeup = std::move(wakeup);
+}
+
+int Execution::getMainThreadTaskCount() const {
+    QMutexLocker locker(&m_mainThreadMutex);
+    return static_cast<int>(m_mainThreadTasks.size());
+}
+
+int Execution::getMainThreadTasksRunLastFrame() const {
+    QMutexLocker locker(&m_mainThreadMutex);
+    return m_mainThreadTasksRunLastFrame;
+}
+
+void Execution::enqueueMainThreadTask(std::function<void()> task) {
+    std::function<bool()> wakeup;
+    {
+        QMutexLocker locker(&m_mainThreadMutex);
+        m_mainThreadTasks.append(std::move(task));
+        if (m_mainThreadWakePending) {
+            // The drain already asked for has not started yet and will find it.
+            return;
+        }
+        m_mainThreadWakePending = true;
+        wakeup = m_mainThreadWakeup;
+    }
+    if (!wakeup || !wakeup()) {
+        QMetaObject::invokeMethod(QCoreApplication::instance(), &drainMainThreadTasksFromEventLoop,
+                                  Qt::QueuedConnection);
+    }
+}
+
+bool Execution::cancelTimedTask(quint64 timerId) {
+    return m_timerWheel.cancel(timerId);
+}
+
+TimerWheel::Stats Execution::getTimerStats() const {
+    return m_timerWheel.getStats();
+}
+
+bool Execution::raiseTaskPriority(quint64 taskId, Priority priority) {
+    return m_scheduler.raisePriority(taskId, static_cast<int>(priority));
 }
@@ -1,18 +1,29 @@
 #include "core/GameManager.h"
 #include "core/Configuration.h"
 #include "core/Execution.h"
+#include "resources/LoadGroup.h"
+#include "resources/Loader.h"
+#include "resources/MediaPlayerPool.h"
+#include "resources/ResourceCache.h"
 #include "resources/Resources.h"
 
 #include <QDateTime>
 #include <QDebug>
+#include <QEvent>
 #include <QFile>
 #include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
+#include <QMutexLocker>
+#include <QSet>
+#include <QThread>
+
+#include <utility>
 
 namespace {
 constexpr int MaxFixedUpdateStepsPerFrame = 8;
+constexpr int DefaultPrefetchShots = 2;
 GameManager* g_gameManagerInstance = nullptr;
 
 QVariantMap storyStepAt(const QVariantList& storyData, int index) {
@@ -25,13 +36,45 @@ QVariantMap storyStepAt(const QVariantList& storyData, int index) {
 int storyShotAt(const QVariantList& storyData, int index) {
     return storyStepAt(storyData, index).value(QStringLiteral("shot")).toInt(0);
 }
+
+// Any string in a story step that names a registered resource is an asset
+// reference (backgrounds, portraits inside charA/B/C, audio cues, ...).
+void collectAssetReferences(const QVariant& value, const Resources& resources,
+                            QSet<QString>& seen, QStringList& out) {
+    if (value.typeId() == QMetaType::QVariantMap) {
+        const QVariantMap map = value.toMap();
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+            collectAssetReferences(it.value(), resources, seen, out);
+        }
+        return;
+    }
+    if (value.typeId() != QMetaType::QString) {
+        return;
+    }
+    const QString name = value.toString();
+    if (name.isEmpty() || seen.contains(name) || !resources.hasLoader(name)) {
+        return;
+    }
+    seen.insert(name);
+    out.append(name);
+}
 }
 
 GameManager::GameManager(QObject* parent)
     : QObject(parent)
     , m_state(State::Stopped)
+    , m_activeSceneReady(false)
     , m_frameUpdateInProgress(false)
+    , m_onDemandRendering(true)
+    , m_frameRequested(0)
+    , m_idle(0)
+    , m_activeFrameCount(0)
+    , m_idleFrameCount(0)
+    , m_idlePeriodCount(0)
     , m_currentStoryStep(0)
+    , m_nextPrefetchId(0)
+    , m_loadProgress(1.0)
+    , m_mainThreadDrainPosted(0)
 {
 }
 
@@ -50,6 +93,9 @@ void GameManager::setInstance(GameManager* instance) {
 void GameManager::initialize() {
     qDebug() << "GameManager initialized";
     m_state = State::Stopped;
+    m_onDemandRendering = Configuration::getInstance()
+        .getValue(QStringLiteral("render.on_demand"), true)
+        .toBool();
     loadScenesFromResources();
     if (m_activeScene.isNull() && !m_scenes.isEmpty()) {
         setActiveScene(m_scenes.constBegin().key());
@@ -92,7 +138,7 @@ void GameManager::update() {
     if (m_state != State::Running) {
         return;
     }
-    if (m_activeScene) {
+    if (m_activeScene && m_activeSceneReady) {
         m_activeScene->update();
     }
 }
@@ -101,7 +147,7 @@ void GameManager::fixedUpdate() {
     if (m_state != State::Running) {
         return;
     }
-    if (m_activeScene) {
+    if (m_activeScene && m_activeSceneReady) {
         m_activeScene->fixedUpdate();
     }
 }
@@ -115,6 +161,7 @@ void GameManager::setState(State newState) {
         return;
     }
     m_state = newState;
+    requestFrame();
     emit gameStateChanged();
     qDebug() << "Game state:" << getGameState();
 }
@@ -159,6 +206,10 @@ bool GameManager::removeScene(const QString& name) {
         qWarning() << "Cannot remove active scene:" << name;
         return false;
     }
+    {
+        QMutexLocker locker(&m_sceneReloadMutex);
+        m_releasedScenes.remove(m_scenes.value(name).data());
+    }
     m_scenes.remove(name);
     return true;
 }
@@ -175,14 +226,57 @@ bool GameManager::setActiveScene(const QString& name) {
     if (m_activeScene) {
         qDebug() << "Switching from scene:" << m_activeSceneName;
     }
-    m_activeScene = m_scenes.value(name);
-    m_activeSceneName = name;
-    m_activeScene->initialize();
+    {
+        QMutexLocker locker(&m_sceneReloadMutex);
+        m_activeScene = m_scenes.value(name);
+        m_activeSceneName = name;
+        m_activeSceneReady = false;
+        if (m_releasedScenes.remove(m_activeScene.data())) {
+            qDebug() << "Rebuilding released scene:" << name;
+            m_activeScene->load(m_activeScene->getSourceUrl());
+        }
+    }
+    // Finishes right here when the scene's assets are already cached.
+    setUpActiveScene(m_activeScene);
     emit activeSceneChanged();
     qDebug() << "Active scene set to:" << name;
     return true;
 }
 
+AsyncTask<> GameManager::setUpActiveScene(QSharedPointer<Scene> scene) {
+    const Resources& resources = Resources::getInstance();
+    QSet<QString> seen;
+    QStringList names;
+    for (const QSharedPointer<Item>& item : scene->getItems()) {
+        for (const QString& source : item->getResourceSources()) {
+            collectAssetReferences(source, resources, seen, names);
+        }
+    }
+    // Start every load before awaiting any, so they run in parallel.
+    QList<AsyncTask<QSharedPointer<Resource>>> loads;
+    loads.reserve(names.size());
+    for (const QString& name : names) {
+        loads.append(resources.getLoader(name)->loadAsync({}, Execution::Priority::Immediate));
+    }
+    const QList<QSharedPointer<Resource>> loaded = co_await whenAll(std::move(loads));
+    for (qsizetype i = 0; i < loaded.size(); ++i) {
+        if (loaded[i].isNull()) {
+            qWarning() << "Scene" << scene->getId() << "starts without asset:" << names[i];
+        }
+    }
+
+    if (m_activeScene != scene) {
+        // Switched away while loading; the next activation sets it up again.
+        co_return;
+    }
+    {
+        QMutexLocker locker(&m_sceneReloadMutex);
+        scene->initialize();
+        m_activeSceneReady = true;
+    }
+    requestFrame();
+}
+
 QSharedPointer<Scene> GameManager::getActiveScene() const {
     return m_activeScene;
 }
@@ -198,7 +292,19 @@ void GameManager::attachRenderWindow(QQuickWindow* window) {
     m_renderWindow = window;
     QObject::connect(m_renderWindow, &QQuickWindow::beforeRendering,
                      this, &GameManager::processFrame, Qt::DirectConnection);
-    // m_renderWindow->requestUpdate();
+    // Input wakes the frame loop from idle.
+    m_renderWindow->installEventFilter(this);
+    // Queued main-thread work is drained per frame while frames are rendered,
+    // and from the event loop otherwise (see wakeMainThreadDrain()).
+    QPointer<GameManager> guardedManager(this);
+    Execution::getInstance().setMainThreadWakeup([guardedManager]() {
+        if (guardedManager.isNull()) {
+            return false;
+        }
+        QMetaObject::invokeMethod(guardedManager.data(), &GameManager::wakeMainThreadDrain, Qt::QueuedConnection);
+        return true;
+    });
+    requestFrame();
 }
 
 void GameManager::processFrame() {
@@ -206,18 +312,332 @@ void GameManager::processFrame() {
         return;
     }
     m_frameUpdateInProgress = true;
-    Execution& execution = Execution::getInstance();
-    execution.update();
-    update();
-    int fixedStepCount = 0;
-    while (execution.shouldFixedUpdate() && fixedStepCount < MaxFixedUpdateStepsPerFrame) {
-        fixedUpdate();
-        ++fixedStepCount;
+    const bool requested = m_frameRequested.fetchAndStoreAcquire(0) != 0;
+    const bool runUpdates = requested || !m_onDemandRendering || hasPendingFrameWork();
+    if (runUpdates) {
+        // Hot reloads rebuild items on the GUI thread; keep them out of the updates.
+        QMutexLocker sceneLocker(&m_sceneReloadMutex);
+        Execution& execution = Execution::getInstance();
+        execution.update();
+        update();
+        int fixedStepCount = 0;
+        while (execution.shouldFixedUpdate() && fixedStepCount < MaxFixedUpdateStepsPerFrame) {
+            fixedUpdate();
+            ++fixedStepCount;
+        }
+        m_activeFrameCount.fetchAndAddRelaxed(1);
+    } else {
+        // Rendered for something else (a QML animation, a resize); nothing
+        // in the scene asked for an update.
+        m_idleFrameCount.fetchAndAddRelaxed(1);
+    }
+    drainMainThreadTasks();
+    if (!m_onDemandRendering || hasPendingFrameWork()) {
+        m_idle.storeRelease(0);
+        scheduleFrame();
+    } else {
+        if (m_idle.testAndSetOrdered(0, 1)) {
+            m_idlePeriodCount.fetchAndAddRelaxed(1);
+        }
+        if (runUpdates) {
+            // Also after a single requested frame: the wait for the next one
+            // must not count as simulated time either.
+            Execution::getInstance().suspendFrameClock();
+        }
     }
     m_frameUpdateInProgress = false;
-    // if (!m_renderWindow.isNull()) {
-    //     m_renderWindow->requestUpdate();
-    // }
+}
+
+// ── On-demand frames ───────────────────────────────────────────────────────
+
+void GameManager::requestFrame() {
+    m_frameRequested.storeRelease(1);
+    scheduleFrame();
+}
+
+bool GameManager::isIdle() const {
+    return m_idle.loadAcquire() != 0;
+}
+
+GameManager::FrameStats GameManager::getFrameStats() const {
+    FrameStats stats;
+    stats.activeFrames = m_activeFrameCount.loadRelaxed();
+    stats.idleFrames = m_idleFrameCount.loadRelaxed();
+    stats.idlePeriods = m_idlePeriodCount.loadRelaxed();
+    return stats;
+}
+
+bool GameManager::eventFilter(QObject* watched, QEvent* event) {
+    switch (event->type()) {
+    case QEvent::KeyPress:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::TouchBegin:
+    case QEvent::Wheel:
+        requestFrame();
+        break;
+    case QEvent::Expose:
+    case QEvent::Hide:
+    case QEvent::WindowStateChange:
+        // A frame requested for queued main-thread work may never come now.
+        if (Execution::getInstance().getMainThreadTaskCount() > 0) {
+            QMetaObject::invokeMethod(this, &GameManager::wakeMainThreadDrain, Qt::QueuedConnection);
+        }
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+bool GameManager::hasPendingFrameWork() {
+    // Called from processFrame, possibly on the render thread, while the GUI
+    // thread swaps the active scene and rebuilds its items under this mutex.
+    QMutexLocker locker(&m_sceneReloadMutex);
+    return m_state == State::Running && m_activeScene && m_activeSceneReady && m_activeScene->hasPendingWork();
+}
+
+void GameManager::scheduleFrame() {
+    QQuickWindow* window = m_renderWindow.data();
+    if (window != nullptr) {
+        // processFrame may run on the render thread; update() belongs to the GUI thread.
+        QMetaObject::invokeMethod(window, &QQuickWindow::update, Qt::QueuedConnection);
+    }
+}
+
+// ── Story-lookahead prefetch ───────────────────────────────────────────────
+
+void GameManager::schedulePrefetch(const QVariantList& storyData, int fromStep) {
+    const int shotsAhead = Configuration::getInstance()
+        .getValue(QStringLiteral("story.prefetch_shots"), DefaultPrefetchShots)
+        .toInt();
+    if (shotsAhead <= 0) {
+        return;
+    }
+    const Resources& resources = Resources::getInstance();
+    QMutexLocker locker(&m_prefetchMutex);
+    QSet<QString> seen(m_prefetchQueue.cbegin(), m_prefetchQueue.cend());
+    int lastShot = storyShotAt(storyData, fromStep);
+    int shotsSeen = 0;
+    for (int step = fromStep + 1; step < storyData.size(); ++step) {
+        const int shot = storyShotAt(storyData, step);
+        if (shot != lastShot) {
+            lastShot = shot;
+            if (++shotsSeen > shotsAhead) {
+                break;
+            }
+        }
+        collectAssetReferences(storyData[step], resources, seen, m_prefetchQueue);
+    }
+    locker.unlock();
+    pumpPrefetch();
+}
+
+void GameManager::cancelPrefetch() {
+    QMutexLocker locker(&m_prefetchMutex);
+    if (!m_prefetchQueue.isEmpty() || !m_prefetchTokens.isEmpty()) {
+        qDebug() << "Cancelled" << m_prefetchQueue.size() << "queued and"
+                 << m_prefetchTokens.size() << "issued prefetches";
+    }
+    m_prefetchQueue.clear();
+    // Queued loads are dropped and running decodes stop early unless an
+    // on-demand load has joined them.
+    for (CancellationToken& token : m_prefetchTokens) {
+        token.cancel();
+    }
+    m_prefetchTokens.clear();
+}
+
+void GameManager::pumpPrefetch() {
+    // Prefetch-class tasks already yield to on-demand loads in Execution; keeping
+    // at most one pool's worth in flight leaves the rest here, where a story
+    // jump can still drop them cheaply.  Each finished load pumps again.
+    const int maxInFlight = Execution::getInstance().getMaxThreadCount();
+    const Resources& resources = Resources::getInstance();
+    const ResourceCache& cache = ResourceCache::getInstance();
+    QMutexLocker locker(&m_prefetchMutex);
+    while (!m_prefetchQueue.isEmpty() && m_prefetchTokens.size() < maxInFlight) {
+        const QString name = m_prefetchQueue.takeFirst();
+        const QSharedPointer<Loader> loader = resources.getLoader(name);
+        if (loader.isNull() || cache.contains(loader->getCacheKey())) {
+            continue;
+        }
+        const quint64 prefetchId = ++m_nextPrefetchId;
+        CancellationToken token;
+        const QFuture<QSharedPointer<Resource>> future =
+            loader->requestLoad({}, Execution::Priority::Prefetch, token);
+        m_prefetchTokens.insert(prefetchId, token);
+        locker.unlock();
+        // Runs on the worker that finished the load (or here, if it already has).
+        const auto finishPrefetch = [this, prefetchId]() {
+            {
+                QMutexLocker finishLocker(&m_prefetchMutex);
+                m_prefetchTokens.remove(prefetchId);
+            }
+            QMetaObject::invokeMethod(this, &GameManager::pumpPrefetch, Qt::QueuedConnection);
+        };
+        future
+            .then(QtFuture::Launch::Sync, [finishPrefetch](const QSharedPointer<Resource>&) {
+                finishPrefetch();
+            })
+            .onCanceled(finishPrefetch);
+        locker.relock();
+    }
+}
+
+void GameManager::loadShot(const QVariantList& storyData, int step, const QStringList& screenAssets) {
+    const Resources& resources = Resources::getInstance();
+    QSet<QString> seen;
+    QStringList names;
+    for (const QString& name : screenAssets) {
+        collectAssetReferences(name, resources, seen, names);
+    }
+    const int shot = storyShotAt(storyData, step);
+    for (int index = qMax(0, step); index < storyData.size() && storyShotAt(storyData, index) == shot; ++index) {
+        collectAssetReferences(storyData[index], resources, seen, names);
+    }
+
+    cancelShotLoad();
+    if (names.isEmpty()) {
+        return;
+    }
+    m_shotLoad = resources.createLoadGroup(names, Execution::Priority::Immediate);
+    connect(m_shotLoad.data(), &LoadGroup::progressChanged, this,
+            [this](int loadedCount, int totalCount, qint64 loadedBytes, qint64 totalBytes) {
+                if (totalBytes > 0) {
+                    setLoadProgress(static_cast<qreal>(loadedBytes) / static_cast<qreal>(totalBytes));
+                } else if (totalCount > 0) {
+                    setLoadProgress(static_cast<qreal>(loadedCount) / static_cast<qreal>(totalCount));
+                }
+            });
+    connect(m_shotLoad.data(), &LoadGroup::finished, this, &GameManager::finishShotLoad);
+    setLoadProgress(0.0);
+    emit loadingChanged();
+    m_shotLoad->start();
+}
+
+void GameManager::cancelShotLoad() {
+    if (m_shotLoad.isNull()) {
+        return;
+    }
+    disconnect(m_shotLoad.data(), nullptr, this, nullptr);
+    m_shotLoad->cancel();
+    finishShotLoad();
+}
+
+void GameManager::setLoadProgress(qreal progress) {
+    if (qFuzzyCompare(m_loadProgress, progress)) {
+        return;
+    }
+    m_loadProgress = progress;
+    emit loadProgressChanged();
+}
+
+void GameManager::finishShotLoad() {
+    // The group may be the sender; its deleter defers the deletion.
+    m_shotLoad.reset();
+    setLoadProgress(1.0);
+    emit loadingChanged();
+}
+
+// ── Main-thread deferred work ─────────────────────────────────────────────
+
+void GameManager::drainMainThreadTasks() {
+    if (QThread::currentThread() != thread()) {
+        // Threaded render loop: the GUI thread runs concurrently with rendering,
+        // so hand this frame's drain to it (once, however many frames pass).
+        if (m_mainThreadDrainPosted.testAndSetOrdered(0, 1)) {
+            QMetaObject::invokeMethod(this, &GameManager::drainMainThreadTasks, Qt::QueuedConnection);
+        }
+        return;
+    }
+    m_mainThreadDrainPosted.storeRelease(0);
+    if (Execution::getInstance().runMainThreadTasks() > 0) {
+        // Carried over to the next frame, or the next event loop turn.
+        wakeMainThreadDrain();
+    }
+}
+
+void GameManager::wakeMainThreadDrain() {
+    if (isRenderingFrames()) {
+        m_renderWindow->update();
+    } else {
+        // Hidden, minimised or unexposed windows render no frames.
+        QMetaObject::invokeMethod(this, &GameManager::drainMainThreadTasks, Qt::QueuedConnection);
+    }
+}
+
+bool GameManager::isRenderingFrames() const {
+    const QQuickWindow* window = m_renderWindow.data();
+    return window != nullptr && window->isExposed()
+        && window->visibility() != QWindow::Hidden && window->visibility() != QWindow::Minimized;
+}
+
+// ── Scene hot reload ──────────────────────────────────────────────────────
+
+void GameManager::reloadScenesFromFile(const QString& filePath) {
+    const QString changedPath = QFileInfo(filePath).absoluteFilePath();
+    for (auto it = m_scenes.constBegin(); it != m_scenes.constEnd(); ++it) {
+        // Embedded scenes never change; with resources.dev_asset_dir set, scenes
+        // are loaded from the loose files instead.
+        const QString& sourceUrl = it.value()->getSourceUrl();
+        if (sourceUrl.startsWith("qrc:/") || sourceUrl.startsWith(":/")
+            || QFileInfo(sourceUrl).suffix().toLower() != "json"
+            || QFileInfo(sourceUrl).absoluteFilePath() != changedPath) {
+            continue;
+        }
+        QWeakPointer<Scene> scene = it.value();
+        Execution::getInstance().dispatchAsyncTask([this, scene, changedPath]() {
+            SceneReload reload;
+            reload.scene = scene;
+            if (!Scene::readJsonItems(changedPath, reload.items)) {
+                return;
+            }
+            {
+                QMutexLocker locker(&m_sceneReloadMutex);
+                m_sceneReloads.append(reload);
+            }
+            // Items are QObjects of the GUI thread; build them there.
+            QMetaObject::invokeMethod(this, &GameManager::applySceneReloads, Qt::QueuedConnection);
+        });
+    }
+}
+
+void GameManager::applySceneReloads() {
+    QMutexLocker locker(&m_sceneReloadMutex);
+    const QList<SceneReload> reloads = std::exchange(m_sceneReloads, {});
+    int changedCount = 0;
+    for (const SceneReload& reload : reloads) {
+        const QSharedPointer<Scene> scene = reload.scene.toStrongRef();
+        // A released scene is rebuilt from its (already changed) source anyway.
+        if (scene.isNull() || m_releasedScenes.contains(scene.data())) {
+            continue;
+        }
+        const int sceneChangedCount = scene->applyChangedItems(reload.items);
+        changedCount += sceneChangedCount;
+        qDebug() << "Hot reloaded scene" << scene->getId() << "-" << sceneChangedCount << "items changed";
+    }
+    locker.unlock();
+    if (changedCount > 0) {
+        requestFrame();
+    }
+}
+
+// ── Memory pressure ───────────────────────────────────────────────────────
+
+int GameManager::releaseInactiveScenes() {
+    QMutexLocker locker(&m_sceneReloadMutex);
+    int releasedCount = 0;
+    for (auto it = m_scenes.constBegin(); it != m_scenes.constEnd(); ++it) {
+        const QSharedPointer<Scene>& scene = it.value();
+        if (scene == m_activeScene || scene->getItems().isEmpty() || scene->getSourceUrl().isEmpty()) {
+            continue;
+        }
+        scene->clear();
+        m_releasedScenes.insert(scene.data());
+        ++releasedCount;
+    }
+    return releasedCount;
 }
 
 // ── Game-flow invokables ───────────────────────────────────────────────────
@@ -226,6 +646,9 @@ void GameManager::startGame(int fromStep) {
     setCurrentStoryStep(fromStep);
     setState(State::Running);
     setCurrentScreen(QStringLiteral("game"));
+    // Create the media players while the game screen loads rather than on
+    // the first play(); queued so the screen switch is not held up by it.
+    QMetaObject::invokeMethod(&MediaPlayerPool::getInstance(), &MediaPlayerPool::prewarm, Qt::QueuedConnection);
     qDebug() << "Game started at step:" << fromStep;
 }
 
@@ -306,6 +729,8 @@ QVariantMap GameManager::advanceStory(const QVariantList& storyData, const QVari
         updatedVisitedShots.append(nextShot);
     }
 
+    schedulePrefetch(storyData, nextStep);
+
     result["advanced"] = true;
     result["nextStep"] = nextStep;
     result["shotChanged"] = shotChanged;
@@ -397,6 +822,11 @@ void GameManager::setCurrentStoryStep(int step) {
     if (m_currentStoryStep == step) {
         return;
     }
+    // Anything other than a single forward step (route menu, load, restart) makes
+    // the queued lookahead stale.
+    if (step != m_currentStoryStep + 1) {
+        cancelPrefetch();
+    }
     m_currentStoryStep = step;
     emit currentStoryStepChanged();
 }
@@ -420,6 +850,14 @@ int GameManager::getSavedStep() const {
     return doc.object().value("current_step").toInt(0);
 }
 
+bool GameManager::isLoading() const {
+    return !m_shotLoad.isNull();
+}
+
+qreal GameManager::getLoadProgress() const {
+    return m_loadProgress;
+}
+
 QString GameManager::getCurrentScreen() const {
     return m_currentScreen;
 }
@@ -441,6 +879,10 @@ void GameManager::setCurrentScreen(const QString& screen) {
     if (m_currentScreen == screen) {
         return;
     }
+    if (m_currentScreen == QStringLiteral("game")) {
+        cancelPrefetch();
+        cancelShotLoad();
+    }
     m_currentScreen = screen;
     emit currentScreenChanged();
 }
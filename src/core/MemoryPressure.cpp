@@ -0,0 +1,144 @@
+#include "core/MemoryPressure.h"
+
+#include "core/Configuration.h"
+#include "core/GameManager.h"
+#include "resources/ResourceCache.h"
+
+#include <QByteArrayList>
+#include <QDebug>
+#include <QFile>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr qint64 BytesPerMegabyte = 1024 * 1024;
+constexpr int DefaultRssThresholdMb = 2048;
+constexpr int DefaultPollIntervalMs = 2000;
+}
+
+MemoryPressure::MemoryPressure()
+    : QObject(nullptr)
+    , m_thresholdBytes(0)
+    , m_overThreshold(false)
+{
+    connect(&m_pollTimer, &QTimer::timeout, this, &MemoryPressure::pollResidentSize);
+}
+
+MemoryPressure& MemoryPressure::getInstance() {
+    static MemoryPressure instance;
+    return instance;
+}
+
+void MemoryPressure::initialize() {
+    const Configuration& config = Configuration::getInstance();
+    m_thresholdBytes = static_cast<qint64>(config
+        .getValue(QStringLiteral("memory.rss_threshold_mb"), DefaultRssThresholdMb)
+        .toInt()) * BytesPerMegabyte;
+    if (m_thresholdBytes <= 0 || readResidentBytes() < 0) {
+        m_pollTimer.stop();
+        return;
+    }
+    m_pollTimer.start(config
+        .getValue(QStringLiteral("memory.poll_interval_ms"), DefaultPollIntervalMs)
+        .toInt());
+}
+
+qint64 MemoryPressure::relieve(Tier deepest, const QString& reason, qint64 targetResidentBytes) {
+    ResourceCache& cache = ResourceCache::getInstance();
+    GameManager& gameManager = GameManager::getInstance();
+    const qint64 residentBefore = readResidentBytes();
+    qint64 releasedBytes = 0;
+    int releasedScenes = 0;
+    Tier reached = Tier::Prefetch;
+    for (int tierIndex = 0; tierIndex <= static_cast<int>(deepest); ++tierIndex) {
+        reached = static_cast<Tier>(tierIndex);
+        switch (reached) {
+        case Tier::Prefetch:
+            gameManager.cancelPrefetch();
+            releasedBytes += cache.releaseUnused();
+            break;
+        case Tier::OffscreenTextures:
+            releasedBytes += cache.releaseTextures();
+            break;
+        case Tier::InactiveScenes:
+            releasedScenes += gameManager.releaseInactiveScenes();
+            // Their items held textures the previous tier had to keep.
+            releasedBytes += cache.releaseTextures();
+            break;
+        }
+        if (targetResidentBytes > 0 && readResidentBytes() < targetResidentBytes) {
+            break;
+        }
+    }
+
+    ++m_stats.events;
+    m_stats.releasedBytes += releasedBytes;
+    m_stats.releasedScenes += releasedScenes;
+    qDebug() << "Memory pressure (" << reason << "): released" << releasedBytes << "cached bytes and"
+             << releasedScenes << "scenes up to tier" << tierName(reached)
+             << "- RSS" << residentBefore << "->" << readResidentBytes() << "bytes";
+    return releasedBytes;
+}
+
+qint64 MemoryPressure::readResidentBytes() {
+#ifdef Q_OS_LINUX
+    // statm: size resident shared text lib data dt, all in pages.
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QByteArrayList fields = statm.readAll().split(' ');
+    bool ok = false;
+    const qint64 residentPages = fields.size() > 1 ? fields.at(1).toLongLong(&ok) : 0;
+    return ok ? residentPages * static_cast<qint64>(sysconf(_SC_PAGESIZE)) : -1;
+#else
+    return -1;
+#endif
+}
+
+MemoryPressure::Stats MemoryPressure::getStats() const {
+    return m_stats;
+}
+
+void MemoryPressure::handleApplicationStateChange(Qt::ApplicationState state) {
+    switch (state) {
+    case Qt::ApplicationInactive:
+        // On desktop this is just losing focus; the window is still on screen.
+        relieve(Tier::Prefetch, QStringLiteral("application inactive"));
+        break;
+    case Qt::ApplicationHidden:
+    case Qt::ApplicationSuspended:
+        relieve(Tier::InactiveScenes, QStringLiteral("application in background"));
+        break;
+    case Qt::ApplicationActive:
+    default:
+        break;
+    }
+}
+
+void MemoryPressure::pollResidentSize() {
+    const qint64 residentBytes = readResidentBytes();
+    if (residentBytes < m_thresholdBytes) {
+        m_overThreshold = false;
+        return;
+    }
+    if (m_overThreshold) {
+        return;
+    }
+    m_overThreshold = true;
+    relieve(Tier::InactiveScenes, QStringLiteral("RSS over threshold"), m_thresholdBytes);
+}
+
+const char* MemoryPressure::tierName(Tier tier) {
+    switch (tier) {
+    case Tier::Prefetch:
+        return "prefetch";
+    case Tier::OffscreenTextures:
+        return "off-screen textures";
+    case Tier::InactiveScenes:
+    default:
+        return "inactive scenes";
+    }
+}
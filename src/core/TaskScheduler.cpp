@@ -0,0 +1,365 @@
+#include "core/TaskScheduler.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QPromise>
+#include <QRandomGenerator>
+
+namespace {
+constexpr qint64 DefaultAgingNs = 250 * 1000000LL;
+}
+
+struct TaskScheduler::GraphRun {
+    QAtomicInt remaining;
+    CancellationToken token;
+    QPromise<void> promise;
+};
+
+struct TaskScheduler::Task {
+    quint64 id = 0;
+    qint64 enqueuedNs = 0;
+    CancellationToken token;
+    std::function<void()> work;
+    // Predecessors that have not finished yet; the task is ready at zero.
+    QAtomicInt joinCount;
+    QList<TaskRef> successors;
+    QSharedPointer<GraphRun> graph;
+};
+
+void TaskGraph::precede(Node before, Node after) {
+    if (before < 0 || before >= m_nodes.size() || after < 0 || after >= m_nodes.size() || before == after) {
+        qWarning() << "Invalid task graph edge:" << before << "->" << after;
+        return;
+    }
+    m_nodes[before].successors.append(after);
+    ++m_nodes[after].predecessorCount;
+}
+
+int TaskGraph::size() const {
+    return static_cast<int>(m_nodes.size());
+}
+
+bool TaskGraph::isEmpty() const {
+    return m_nodes.isEmpty();
+}
+
+TaskScheduler::TaskScheduler()
+    : m_configuredWorkerCount(qMax(1, QThread::idealThreadCount()))
+    , m_stopping(0)
+    , m_agingNs(DefaultAgingNs)
+    , m_nextTaskId(0)
+    , m_pendingTasks(0)
+    , m_sleepingWorkers(0)
+    , m_activeWorkers(0)
+    , m_droppedTaskCount(0)
+    , m_stolenTaskCount(0)
+{
+    m_queueClock.start();
+}
+
+TaskScheduler::~TaskScheduler() {
+    shutdown();
+}
+
+void TaskScheduler::setWorkerCount(int workerCount) {
+    QMutexLocker locker(&m_mutex);
+    m_configuredWorkerCount = qMax(1, workerCount);
+    if (!m_workers.isEmpty() && m_configuredWorkerCount > m_workers.size()) {
+        startWorkersLocked(m_configuredWorkerCount);
+    }
+}
+
+int TaskScheduler::getWorkerCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_workers.isEmpty() ? m_configuredWorkerCount : static_cast<int>(m_workers.size());
+}
+
+int TaskScheduler::getActiveWorkerCount() const {
+    return m_activeWorkers.loadRelaxed();
+}
+
+void TaskScheduler::setAgingInterval(qint64 agingNs) {
+    QMutexLocker locker(&m_mutex);
+    m_agingNs = qMax<qint64>(1, agingNs);
+}
+
+int TaskScheduler::getQueuedTaskCount(int priority) const {
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_queues[priority].size());
+}
+
+quint64 TaskScheduler::getDroppedTaskCount() const {
+    return m_droppedTaskCount.loadRelaxed();
+}
+
+quint64 TaskScheduler::getStolenTaskCount() const {
+    return m_stolenTaskCount.loadRelaxed();
+}
+
+quint64 TaskScheduler::submit(std::function<void()> work, int priority, const CancellationToken& token) {
+    const TaskRef task = TaskRef::create();
+    task->token = token;
+    task->work = std::move(work);
+    return enqueueShared(task, priority);
+}
+
+QFuture<void> TaskScheduler::submitGraph(TaskGraph graph, int priority, const CancellationToken& token,
+                                         QList<quint64>* rootTaskIds) {
+    const QSharedPointer<GraphRun> run = QSharedPointer<GraphRun>::create();
+    run->token = token;
+    run->promise.start();
+    const QFuture<void> future = run->promise.future();
+
+    // Kahn's walk: every node is reached only if the graph has no cycle.
+    QList<int> pending(graph.m_nodes.size());
+    QList<TaskGraph::Node> ready;
+    for (qsizetype node = 0; node < graph.m_nodes.size(); ++node) {
+        pending[node] = graph.m_nodes[node].predecessorCount;
+        if (pending[node] == 0) {
+            ready.append(static_cast<TaskGraph::Node>(node));
+        }
+    }
+    const QList<TaskGraph::Node> roots = ready;
+    qsizetype reached = 0;
+    while (reached < ready.size()) {
+        for (TaskGraph::Node successor : graph.m_nodes[ready[reached]].successors) {
+            if (--pending[successor] == 0) {
+                ready.append(successor);
+            }
+        }
+        ++reached;
+    }
+    if (reached != graph.m_nodes.size()) {
+        qWarning() << "Task graph has a cycle; rejected" << graph.m_nodes.size() << "tasks";
+        run->promise.future().cancel();
+    }
+    if (graph.isEmpty() || reached != graph.m_nodes.size()) {
+        run->promise.finish();
+        return future;
+    }
+
+    QList<TaskRef> tasks;
+    tasks.reserve(graph.m_nodes.size());
+    for (TaskGraph::NodeSpec& node : graph.m_nodes) {
+        const TaskRef task = TaskRef::create();
+        task->token = token;
+        task->work = std::move(node.work);
+        task->joinCount.storeRelaxed(node.predecessorCount);
+        task->graph = run;
+        tasks.append(task);
+    }
+    for (qsizetype node = 0; node < graph.m_nodes.size(); ++node) {
+        for (TaskGraph::Node successor : graph.m_nodes[node].successors) {
+            tasks[node]->successors.append(tasks[successor]);
+        }
+    }
+    run->remaining.storeRelease(static_cast<int>(tasks.size()));
+    for (TaskGraph::Node root : roots) {
+        const quint64 taskId = enqueueShared(tasks[root], priority);
+        if (rootTaskIds != nullptr) {
+            rootTaskIds->append(taskId);
+        }
+    }
+    return future;
+}
+
+bool TaskScheduler::raisePriority(quint64 taskId, int priority) {
+    QMutexLocker locker(&m_mutex);
+    for (int queueIndex = priority + 1; queueIndex < PriorityCount; ++queueIndex) {
+        QList<TaskRef>& queue = m_queues[queueIndex];
+        for (qsizetype i = 0; i < queue.size(); ++i) {
+            if (queue[i]->id == taskId) {
+                // Keeps its original enqueue time, so it also keeps the aging it earned.
+                m_queues[priority].append(queue.takeAt(i));
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::shutdown() {
+    {
+        QMutexLocker sleepLocker(&m_sleepMutex);
+        m_stopping.storeRelease(1);
+        m_wakeCondition.wakeAll();
+    }
+    QList<QSharedPointer<Worker>> workers;
+    QList<TaskRef> discarded;
+    {
+        QMutexLocker locker(&m_mutex);
+        workers = m_workers;
+    }
+    for (const QSharedPointer<Worker>& worker : workers) {
+        worker->thread->wait();
+        delete worker->thread;
+        worker->thread = nullptr;
+        discarded.append(worker->deque);
+        worker->deque.clear();
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_workers.clear();
+        for (QList<TaskRef>& queue : m_queues) {
+            discarded.append(queue);
+            queue.clear();
+        }
+    }
+    // Destroyed outside the lock: captures may run arbitrary destructors.
+    discarded.clear();
+}
+
+void TaskScheduler::startWorkersLocked(int workerCount) {
+    while (m_workers.size() < workerCount) {
+        const QSharedPointer<Worker> worker = QSharedPointer<Worker>::create();
+        worker->index = static_cast<int>(m_workers.size());
+        Worker* rawWorker = worker.data();
+        worker->thread = QThread::create(&TaskScheduler::workerLoop, this, rawWorker);
+        worker->thread->setObjectName(QStringLiteral("TaskWorker-%1").arg(worker->index));
+        m_workers.append(worker);
+        worker->thread->start();
+    }
+}
+
+void TaskScheduler::workerLoop(Worker* worker) {
+    while (m_stopping.loadAcquire() == 0) {
+        const TaskRef task = takeTask(worker);
+        if (!task.isNull()) {
+            runTask(worker, task);
+            continue;
+        }
+        QMutexLocker sleepLocker(&m_sleepMutex);
+        // Submitters count a task before waking anyone, so checking under the
+        // sleep lock cannot miss a wake-up.
+        if (m_stopping.loadAcquire() != 0 || m_pendingTasks.loadAcquire() > 0) {
+            continue;
+        }
+        ++m_sleepingWorkers;
+        m_wakeCondition.wait(&m_sleepMutex);
+        --m_sleepingWorkers;
+    }
+}
+
+TaskScheduler::TaskRef TaskScheduler::takeTask(Worker* worker) {
+    {
+        QMutexLocker locker(&worker->dequeMutex);
+        if (!worker->deque.isEmpty()) {
+            m_pendingTasks.deref();
+            return worker->deque.takeLast();
+        }
+    }
+    const TaskRef task = takeShared();
+    return task.isNull() ? steal(worker) : task;
+}
+
+TaskScheduler::TaskRef TaskScheduler::takeShared() {
+    QMutexLocker locker(&m_mutex);
+    const qint64 nowNs = m_queueClock.nsecsElapsed();
+    int bestQueue = -1;
+    qint64 bestRank = 0;
+    // Queues are FIFO, so each head is the most-aged task of its class.
+    for (int queueIndex = 0; queueIndex < PriorityCount; ++queueIndex) {
+        if (m_queues[queueIndex].isEmpty()) {
+            continue;
+        }
+        const qint64 waitedNs = nowNs - m_queues[queueIndex].constFirst()->enqueuedNs;
+        const qint64 rank = qMax<qint64>(0, queueIndex - waitedNs / m_agingNs);
+        if (bestQueue < 0 || rank < bestRank) {
+            bestQueue = queueIndex;
+            bestRank = rank;
+        }
+    }
+    if (bestQueue < 0) {
+        return {};
+    }
+    m_pendingTasks.deref();
+    return m_queues[bestQueue].takeFirst();
+}
+
+TaskScheduler::TaskRef TaskScheduler::steal(Worker* thief) {
+    QList<QSharedPointer<Worker>> workers;
+    {
+        QMutexLocker locker(&m_mutex);
+        workers = m_workers;
+    }
+    const qsizetype count = workers.size();
+    if (count < 2) {
+        return {};
+    }
+    // Random first victim so thieves do not all line up on worker 0.
+    const qsizetype first = static_cast<qsizetype>(QRandomGenerator::global()->bounded(static_cast<quint32>(count)));
+    for (qsizetype i = 0; i < count; ++i) {
+        Worker* victim = workers[(first + i) % count].data();
+        if (victim == thief) {
+            continue;
+        }
+        QMutexLocker locker(&victim->dequeMutex);
+        if (!victim->deque.isEmpty()) {
+            m_pendingTasks.deref();
+            m_stolenTaskCount.fetchAndAddRelaxed(1);
+            // The owner works from the back; the front is the oldest, and
+            // usually the largest, piece of work left.
+            return victim->deque.takeFirst();
+        }
+    }
+    return {};
+}
+
+void TaskScheduler::pushLocal(Worker* worker, const TaskRef& task) {
+    {
+        QMutexLocker locker(&worker->dequeMutex);
+        worker->deque.append(task);
+    }
+    m_pendingTasks.ref();
+    wakeWorker();
+}
+
+void TaskScheduler::runTask(Worker* worker, const TaskRef& task) {
+    if (task->token.isCancelled()) {
+        m_droppedTaskCount.fetchAndAddRelaxed(1);
+    } else {
+        m_activeWorkers.ref();
+        task->work();
+        m_activeWorkers.deref();
+    }
+    // Release captures now rather than whenever the last reference goes.
+    task->work = nullptr;
+
+    const QList<TaskRef> successors = std::exchange(task->successors, {});
+    for (const TaskRef& successor : successors) {
+        if (!successor->joinCount.deref()) {
+            pushLocal(worker, successor);
+        }
+    }
+    const QSharedPointer<GraphRun> graph = std::exchange(task->graph, {});
+    if (!graph.isNull() && !graph->remaining.deref()) {
+        if (graph->token.isCancelled()) {
+            graph->promise.future().cancel();
+        }
+        graph->promise.finish();
+    }
+}
+
+quint64 TaskScheduler::enqueueShared(const TaskRef& task, int priority) {
+    quint64 taskId = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_workers.isEmpty() && m_stopping.loadAcquire() == 0) {
+            startWorkersLocked(m_configuredWorkerCount);
+        }
+        task->id = ++m_nextTaskId;
+        task->enqueuedNs = m_queueClock.nsecsElapsed();
+        taskId = task->id;
+        m_queues[priority].append(task);
+    }
+    m_pendingTasks.ref();
+    wakeWorker();
+    return taskId;
+}
+
+void TaskScheduler::wakeWorker() {
+    QMutexLocker sleepLocker(&m_sleepMutex);
+    if (m_sleepingWorkers > 0) {
+        m_wakeCondition.wakeOne();
+    }
+}
@@ -0,0 +1,296 @@
+#include "core/TimerWheel.h"
+
+#include "core/Execution.h"
+
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+
+#include <chrono>
+#include <utility>
+
+namespace {
+constexpr int DefaultTickMs = 4;
+constexpr qint64 NanosecondsPerMillisecond = 1000000;
+}
+
+TimerWheel::TimerWheel()
+    : m_thread(nullptr)
+    , m_stopping(false)
+    , m_tickNs(DefaultTickMs * NanosecondsPerMillisecond)
+    , m_nextTick(0)
+    , m_slots{}
+    , m_levelCounts{}
+    , m_nextTimerId(0)
+    , m_firedCount(0)
+    , m_cancelledCount(0)
+    , m_firingTickCount(0)
+{
+    m_clock.start();
+}
+
+TimerWheel::~TimerWheel() {
+    shutdown();
+}
+
+void TimerWheel::setTickInterval(int tickMs) {
+    QMutexLocker locker(&m_mutex);
+    // Queued deadlines are in ticks of the current length.
+    if (m_thread == nullptr) {
+        m_tickNs = qMax(1, tickMs) * NanosecondsPerMillisecond;
+    }
+}
+
+quint64 TimerWheel::add(int delayMs, std::function<void()> work, bool onMainThread, int priority) {
+    auto* timer = new Timer;
+    timer->work = std::move(work);
+    timer->onMainThread = onMainThread;
+    timer->priority = priority;
+
+    QMutexLocker locker(&m_mutex);
+    if (m_stopping) {
+        locker.unlock();
+        delete timer;
+        return 0;
+    }
+    const qint64 deadlineNs = m_clock.nsecsElapsed() + qMax(0, delayMs) * NanosecondsPerMillisecond;
+    // Rounded up: a timer never fires early.
+    timer->deadlineTick = static_cast<quint64>((deadlineNs + m_tickNs - 1) / m_tickNs);
+    if (m_timers.isEmpty()) {
+        // Nothing can expire in between, so skip the ticks that passed while idle.
+        m_nextTick = qMax(m_nextTick, currentTickLocked());
+    }
+    timer->id = ++m_nextTimerId;
+    m_timers.insert(timer->id, timer);
+    insertLocked(timer);
+
+    if (m_thread == nullptr) {
+        m_thread = QThread::create(&TimerWheel::run, this);
+        m_thread->setObjectName(QStringLiteral("TimerWheel"));
+        m_thread->start();
+    } else {
+        m_wakeCondition.wakeOne();
+    }
+    return timer->id;
+}
+
+bool TimerWheel::cancel(quint64 timerId) {
+    Timer* timer = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        timer = m_timers.take(timerId);
+        if (timer == nullptr) {
+            return false;
+        }
+        unlinkLocked(timer);
+        ++m_cancelledCount;
+    }
+    // Outside the lock: captures may run arbitrary destructors.
+    delete timer;
+    return true;
+}
+
+TimerWheel::Stats TimerWheel::getStats() const {
+    QMutexLocker locker(&m_mutex);
+    Stats stats;
+    stats.pending = static_cast<int>(m_timers.size());
+    stats.fired = m_firedCount;
+    stats.cancelled = m_cancelledCount;
+    stats.firingTicks = m_firingTickCount;
+    return stats;
+}
+
+void TimerWheel::shutdown() {
+    QThread* thread = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_wakeCondition.wakeAll();
+        thread = std::exchange(m_thread, nullptr);
+    }
+    if (thread != nullptr) {
+        thread->wait();
+        delete thread;
+    }
+    QList<Timer*> discarded;
+    {
+        QMutexLocker locker(&m_mutex);
+        discarded = m_timers.values();
+        m_timers.clear();
+        for (int level = 0; level < LevelCount; ++level) {
+            for (Timer*& head : m_slots[level]) {
+                head = nullptr;
+            }
+            m_levelCounts[level] = 0;
+        }
+    }
+    qDeleteAll(discarded);
+}
+
+quint64 TimerWheel::currentTickLocked() const {
+    return static_cast<quint64>(m_clock.nsecsElapsed() / m_tickNs);
+}
+
+void TimerWheel::insertLocked(Timer* timer) {
+    constexpr quint64 MaxSpan = (quint64(1) << (SlotBits * LevelCount)) - 1;
+    quint64 expires = qMax(timer->deadlineTick, m_nextTick);
+    // Out of range: park at the far end of the last level; expiry re-inserts
+    // it until the real deadline is reached.
+    expires = qMin(expires, m_nextTick + MaxSpan);
+    const quint64 delta = expires - m_nextTick;
+    int level = 0;
+    while (level < LevelCount - 1 && delta >= (quint64(1) << (SlotBits * (level + 1)))) {
+        ++level;
+    }
+    timer->level = level;
+    timer->slot = static_cast<int>((expires >> (SlotBits * level)) & (SlotCount - 1));
+    Timer*& head = m_slots[level][timer->slot];
+    timer->prev = nullptr;
+    timer->next = head;
+    if (head != nullptr) {
+        head->prev = timer;
+    }
+    head = timer;
+    ++m_levelCounts[level];
+}
+
+void TimerWheel::unlinkLocked(Timer* timer) {
+    if (timer->prev != nullptr) {
+        timer->prev->next = timer->next;
+    } else {
+        m_slots[timer->level][timer->slot] = timer->next;
+    }
+    if (timer->next != nullptr) {
+        timer->next->prev = timer->prev;
+    }
+    timer->prev = nullptr;
+    timer->next = nullptr;
+    --m_levelCounts[timer->level];
+}
+
+void TimerWheel::cascadeLocked(int level, int slot) {
+    Timer* timer = std::exchange(m_slots[level][slot], nullptr);
+    while (timer != nullptr) {
+        Timer* next = timer->next;
+        --m_levelCounts[level];
+        insertLocked(timer);
+        timer = next;
+    }
+}
+
+void TimerWheel::advanceLocked(quint64 nowTick, QList<Timer*>& expired) {
+    while (m_nextTick <= nowTick) {
+        const int lowest = lowestOccupiedLevelLocked();
+        if (lowest < 0) {
+            m_nextTick = nowTick + 1;
+            return;
+        }
+        if (lowest > 0) {
+            // The levels below are empty, so nothing happens until the next
+            // tick that cascades this one.
+            const quint64 mask = (quint64(1) << (SlotBits * lowest)) - 1;
+            if ((m_nextTick & mask) != 0) {
+                m_nextTick = qMin((m_nextTick | mask) + 1, nowTick + 1);
+                continue;
+            }
+        }
+        const int index = static_cast<int>(m_nextTick & (SlotCount - 1));
+        if (index == 0) {
+            // Each level is cascaded when the one below it wraps around.
+            for (int level = 1; level < LevelCount; ++level) {
+                const int slot = static_cast<int>((m_nextTick >> (SlotBits * level)) & (SlotCount - 1));
+                cascadeLocked(level, slot);
+                if (slot != 0) {
+                    break;
+                }
+            }
+        }
+        const quint64 tick = m_nextTick++;
+        Timer* timer = std::exchange(m_slots[0][index], nullptr);
+        bool firedThisTick = false;
+        while (timer != nullptr) {
+            Timer* next = timer->next;
+            --m_levelCounts[0];
+            if (timer->deadlineTick > tick) {
+                insertLocked(timer);
+            } else {
+                m_timers.remove(timer->id);
+                expired.append(timer);
+                firedThisTick = true;
+            }
+            timer = next;
+        }
+        if (firedThisTick) {
+            ++m_firingTickCount;
+        }
+    }
+}
+
+int TimerWheel::lowestOccupiedLevelLocked() const {
+    for (int level = 0; level < LevelCount; ++level) {
+        if (m_levelCounts[level] > 0) {
+            return level;
+        }
+    }
+    return -1;
+}
+
+qint64 TimerWheel::nextWakeNsLocked() const {
+    const int lowest = lowestOccupiedLevelLocked();
+    if (lowest < 0) {
+        return -1;
+    }
+    quint64 wakeTick = m_nextTick;
+    if (lowest == 0) {
+        // First occupied slot, or the next cascade if that comes sooner.
+        while (m_slots[0][wakeTick & (SlotCount - 1)] == nullptr && (wakeTick & (SlotCount - 1)) != 0) {
+            ++wakeTick;
+        }
+    } else {
+        const quint64 mask = (quint64(1) << (SlotBits * lowest)) - 1;
+        if ((wakeTick & mask) != 0) {
+            wakeTick = (wakeTick | mask) + 1;
+        }
+    }
+    return qMax<qint64>(0, static_cast<qint64>(wakeTick) * m_tickNs - m_clock.nsecsElapsed());
+}
+
+void TimerWheel::fire(const QList<Timer*>& expired) {
+    Execution& execution = Execution::getInstance();
+    QList<std::function<void()>> mainThreadWork;
+    for (Timer* timer : expired) {
+        if (timer->onMainThread) {
+            mainThreadWork.append(std::move(timer->work));
+        } else {
+            execution.dispatchAsyncTask(std::move(timer->work), static_cast<Execution::Priority>(timer->priority));
+        }
+        delete timer;
+    }
+    if (!mainThreadWork.isEmpty()) {
+        execution.dispatchMainThreadTask([mainThreadWork]() {
+            for (const std::function<void()>& work : mainThreadWork) {
+                work();
+            }
+        });
+    }
+}
+
+void TimerWheel::run() {
+    QMutexLocker locker(&m_mutex);
+    while (!m_stopping) {
+        QList<Timer*> expired;
+        advanceLocked(currentTickLocked(), expired);
+        if (!expired.isEmpty()) {
+            m_firedCount += static_cast<quint64>(expired.size());
+            locker.unlock();
+            fire(expired);
+            locker.relock();
+            continue;
+        }
+        const qint64 waitNs = nextWakeNsLocked();
+        if (waitNs < 0) {
+            m_wakeCondition.wait(&m_mutex);
+        } else if (waitNs > 0) {
+            m_wakeCondition.wait(&m_mutex, QDeadlineTimer(std::chrono::nanoseconds(waitNs), Qt::PreciseTimer));
+        }
+    }
+}
@@ -32,7 +32,7 @@ QObject* NativeItemFactory::create(const PropertyMap& properties) {
         }
         const QString protocol = properties["protocol"].toString();
         const QString suffix = properties["suffix"].toString().toLower();
-        if (protocol != "file" && protocol != "qrc" && protocol != "http" && protocol != "https") {
+        if (protocol != "file" && protocol != "qrc" && protocol != "pack" && protocol != "http" && protocol != "https") {
             throw std::runtime_error("Unsupported protocol: " + protocol.toStdString());
         }
         if (supportedImageSuffixes().contains(suffix)) {
@@ -41,6 +41,8 @@ QObject* NativeItemFactory::create(const PropertyMap& properties) {
             type = "JsonLoader";
         } else if (suffix == "qml") {
             type = "QmlLoader";
+        } else if (suffix == "soundbank") {
+            type = "SoundBankLoader";
         } else {
             qWarning() << "Unrecognized file extension; defaulting to VideoLoader for media playback:" << suffix;
             type = "VideoLoader";
@@ -119,6 +121,10 @@ QObject* NativeItemFactory::create(const PropertyMap& properties) {
         return new QmlLoader();
     }
 
+    if (type == "SoundBankLoader") {
+        return new SoundBankLoader();
+    }
+
     qWarning() << "Unknown native create type:" << type;
     return nullptr;
 }
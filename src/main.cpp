@@ -1,18 +1,87 @@
 #include "core/Configuration.h"
 #include "core/Execution.h"
 #include "core/GameManager.h"
+#include "core/MemoryPressure.h"
 #include "factory/NativeItemFactory.h"
 #include "factory/Registration.h"
+#include "resources/DecodedImageCache.h"
+#include "resources/MediaPlayerPool.h"
+#include "resources/ResourceCache.h"
+#include "resources/ResourceImageProvider.h"
 #include "resources/Resources.h"
+#include "resources/ResourceWatcher.h"
+#include "resources/SoundEffects.h"
+#include "scene/AudioItem.h"
 
 #include <QDebug>
 #include <QGuiApplication>
 #include <QQuickWindow>
 #include <QQmlApplicationEngine>
+#include <QTimer>
 #include <QUrl>
 #include <qqml.h>
 
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#endif
+
 namespace {
+// Startup loading and first frames are left out of an idle CPU sample.
+constexpr int IdleCpuSettleMs = 3000;
+
+// User plus system CPU time of the whole process, or -1 where unsupported.
+double readProcessCpuSeconds() {
+#ifdef Q_OS_UNIX
+    rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+            + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+    }
+#elif defined(Q_OS_WIN)
+    FILETIME creationTime {};
+    FILETIME exitTime {};
+    FILETIME kernelTime {};
+    FILETIME userTime {};
+    if (GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        // 100 ns units.
+        const auto ticks = [](const FILETIME& time) {
+            return (static_cast<quint64>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+        };
+        return static_cast<double>(ticks(kernelTime) + ticks(userTime)) * 1e-7;
+    }
+#endif
+    return -1.0;
+}
+
+// With debug.idle_cpu_sample_ms set, measure the process CPU over that long
+// once startup has settled, log it and quit.  Leave the window on a static
+// screen meanwhile; comparing runs with and without render.on_demand gives
+// the idle CPU before and after on-demand rendering.
+void scheduleIdleCpuSample() {
+    const int sampleMs = Configuration::getInstance()
+        .getValue(QStringLiteral("debug.idle_cpu_sample_ms"), 0)
+        .toInt();
+    if (sampleMs <= 0) {
+        return;
+    }
+    QTimer::singleShot(IdleCpuSettleMs, QCoreApplication::instance(), [sampleMs]() {
+        const double startCpuSeconds = readProcessCpuSeconds();
+        QTimer::singleShot(sampleMs, QCoreApplication::instance(), [sampleMs, startCpuSeconds]() {
+            const double endCpuSeconds = readProcessCpuSeconds();
+            if (startCpuSeconds >= 0.0 && endCpuSeconds >= 0.0) {
+                qDebug() << "Idle CPU over" << sampleMs << "ms:"
+                         << 100.0 * (endCpuSeconds - startCpuSeconds) / (sampleMs / 1000.0)
+                         << "% of one core (render.on_demand ="
+                         << Configuration::getInstance().getValue(QStringLiteral("render.on_demand")).toBool() << ")";
+            } else {
+                qWarning() << "Process CPU time is not available on this platform";
+            }
+            QCoreApplication::quit();
+        });
+    });
+}
 
 void initializeCoreSystems(int argc, char* argv[], QGuiApplication& app) {
     Configuration& config = Configuration::getInstance();
@@ -31,8 +100,18 @@ void initializeCoreSystems(int argc, char* argv[], QGuiApplication& app) {
     execution.setFixedUpdateInterval(1.0f / static_cast<float>(targetFps));
 
     Registration::getInstance().registerFactory(QSharedPointer<NativeItemFactory>::create());
+    ResourceCache::getInstance().initialize();
+    DecodedImageCache::getInstance().initialize();
+    MediaPlayerPool::getInstance().initialize();
+    SoundEffects::getInstance().initialize();
     Resources::getInstance();
+    // Before the scenes load: they only keep what hot reload diffs against while it is on.
+    ResourceWatcher& watcher = ResourceWatcher::getInstance();
+    watcher.initialize();
     GameManager::getInstance().initialize();
+    MemoryPressure::getInstance().initialize();
+    QObject::connect(&watcher, &ResourceWatcher::fileChanged,
+                     &GameManager::getInstance(), &GameManager::reloadScenesFromFile);
 }
 
 bool loadStartupQml(QQmlApplicationEngine& engine, const QString& startupSceneUrl) {
@@ -54,7 +133,51 @@ void shutdownAndLogStats() {
     qDebug() << "=== Engine Statistics ===";
     qDebug() << "Total frames:" << execution.getFrameCount();
     qDebug() << "Total runtime:" << execution.getRuntime() << "s";
+    const GameManager::FrameStats frameStats = gameManager.getFrameStats();
+    qDebug() << "Frames: active" << frameStats.activeFrames << "idle" << frameStats.idleFrames
+             << "in" << frameStats.idlePeriods << "idle periods," << execution.getIdleTime() << "s idle";
+    const double cpuSeconds = readProcessCpuSeconds();
+    if (cpuSeconds >= 0.0) {
+        qDebug() << "Process CPU time:" << cpuSeconds << "s ("
+                 << 100.0 * cpuSeconds / qMax(0.001, static_cast<double>(execution.getRuntime()))
+                 << "% of one core)";
+    }
     qDebug() << "Active scene:" << gameManager.getActiveSceneName();
+    qDebug() << "Cancelled tasks dropped before running:" << execution.getDroppedTaskCount();
+    qDebug() << "Tasks stolen between workers:" << execution.getStolenTaskCount();
+    const TimerWheel::Stats timerStats = execution.getTimerStats();
+    qDebug() << "Timed tasks: fired" << timerStats.fired << "in" << timerStats.firingTicks << "ticks,"
+             << "cancelled" << timerStats.cancelled << "pending" << timerStats.pending;
+    const Resources& resources = Resources::getInstance();
+    qDebug() << "Loaders: live" << resources.getLiveLoaderCount()
+             << "of" << resources.getRegisteredLoaderCount() << "registered";
+    if (ResourceWatcher::getInstance().isEnabled()) {
+        qDebug() << "Hot reloads:" << ResourceWatcher::getInstance().getReloadCount();
+    }
+    const ResourceCache::Stats cacheStats = ResourceCache::getInstance().getStats();
+    qDebug() << "Resource cache: hits" << cacheStats.hits << "misses" << cacheStats.misses
+             << "evictions" << cacheStats.evictions << "coalesced" << cacheStats.coalescedLoads
+             << "cancelled" << cacheStats.cancelledLoads
+             << "idle-evicted" << cacheStats.idleEvictions
+             << "used" << cacheStats.usedBytes
+             << "/" << cacheStats.budgetBytes << "bytes";
+    const MemoryPressure::Stats pressureStats = MemoryPressure::getInstance().getStats();
+    qDebug() << "Memory pressure: events" << pressureStats.events
+             << "released" << pressureStats.releasedBytes << "cached bytes and"
+             << pressureStats.releasedScenes << "scenes";
+    const MediaPlayerPool::Stats playerStats = MediaPlayerPool::getInstance().getStats();
+    qDebug() << "Media players:" << playerStats.created << "created," << playerStats.checkouts
+             << "checkouts," << playerStats.exhausted << "times exhausted";
+    const SoundEffects::Stats soundStats = SoundEffects::getInstance().getStats();
+    qDebug() << "Sound effects: triggers" << soundStats.triggers << "dropped" << soundStats.dropped
+             << "trigger-to-mix latency avg" << soundStats.averageLatencyUs << "us max" << soundStats.maxLatencyUs
+             << "us, sink buffer" << soundStats.sinkBufferUs << "us, output resumed" << soundStats.outputResumes << "times";
+    const DecodedImageCache::Stats diskStats = DecodedImageCache::getInstance().getStats();
+    const quint64 diskLookups = diskStats.hits + diskStats.misses;
+    qDebug() << "Decoded image disk cache: hit rate"
+             << (diskLookups > 0 ? static_cast<double>(diskStats.hits) / static_cast<double>(diskLookups) : 0.0)
+             << "bytes saved" << diskStats.bytesSaved << "writes" << diskStats.writes
+             << "disk" << diskStats.diskBytes << "/" << diskStats.capBytes << "bytes";
     gameManager.setState(GameManager::State::Stopped);
 }
 
@@ -74,11 +197,17 @@ int main(int argc, char* argv[]) {
     Configuration& config = Configuration::getInstance();
     GameManager& gameManager = GameManager::getInstance();
     QObject::connect(&app, &QGuiApplication::applicationStateChanged, &gameManager, &GameManager::handleApplicationStateChange);
+    QObject::connect(&app, &QGuiApplication::applicationStateChanged,
+                     &MemoryPressure::getInstance(), &MemoryPressure::handleApplicationStateChange);
 
     qmlRegisterSingletonInstance("Galgame", 1, 0, "Configuration", &config);
     qmlRegisterSingletonInstance("Galgame", 1, 0, "GameManager", &gameManager);
+    qmlRegisterSingletonInstance("Galgame", 1, 0, "SoundEffects", &SoundEffects::getInstance());
+    qmlRegisterType<AudioItem>("Galgame", 1, 0, "AudioItem");
 
     QQmlApplicationEngine engine;
+    // Engine takes ownership of the provider.
+    engine.addImageProvider(QString::fromLatin1(ResourceImageProvider::ProviderId), new ResourceImageProvider());
     QObject::connect(
         &engine,
         &QQmlApplicationEngine::objectCreationFailed,
@@ -98,6 +227,7 @@ int main(int argc, char* argv[]) {
     }
 
     QObject::connect(&app, &QCoreApplication::aboutToQuit, &shutdownAndLogStats);
+    scheduleIdleCpuSample();
     return app.exec();
 }
 
@@ -0,0 +1,150 @@
+#include "resources/AssetPack.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cstring>
+
+AssetPack::AssetPack(const QString& filePath)
+    : m_filePath(filePath)
+    , m_file(filePath)
+    , m_data(nullptr)
+    , m_dataSize(0)
+    , m_index(nullptr)
+    , m_entryCount(0)
+    , m_stringsOffset(0)
+{
+}
+
+AssetPack::~AssetPack() {
+    if (m_data != nullptr) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+    }
+}
+
+bool AssetPack::open() {
+    if (isOpen()) {
+        return true;
+    }
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "AssetPack failed to open:" << m_filePath << m_file.errorString();
+        return false;
+    }
+    const qint64 fileSize = m_file.size();
+    if (fileSize < static_cast<qint64>(sizeof(AssetPackFormat::Header))) {
+        qWarning() << "AssetPack is too small to hold a header:" << m_filePath;
+        return false;
+    }
+    uchar* mapped = m_file.map(0, fileSize);
+    if (mapped == nullptr) {
+        qWarning() << "AssetPack failed to map:" << m_filePath;
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const AssetPackFormat::Header*>(mapped);
+    const quint32 entryCount = header->entryCount;
+    const qint64 indexOffset = static_cast<qint64>(header->indexOffset);
+    const qint64 stringsOffset = static_cast<qint64>(header->stringsOffset);
+    const qint64 indexBytes = static_cast<qint64>(entryCount) * static_cast<qint64>(sizeof(AssetPackFormat::IndexEntry));
+    const bool valid = std::memcmp(header->magic, AssetPackFormat::Magic, sizeof(header->magic)) == 0
+        && header->version == AssetPackFormat::Version
+        && indexOffset % alignof(AssetPackFormat::IndexEntry) == 0
+        && indexOffset >= static_cast<qint64>(sizeof(AssetPackFormat::Header))
+        && indexOffset + indexBytes <= fileSize
+        && stringsOffset >= indexOffset + indexBytes
+        && stringsOffset <= fileSize;
+    if (!valid) {
+        qWarning() << "AssetPack has an invalid or unsupported header:" << m_filePath;
+        m_file.unmap(mapped);
+        return false;
+    }
+
+    m_data = mapped;
+    m_dataSize = fileSize;
+    m_index = reinterpret_cast<const AssetPackFormat::IndexEntry*>(mapped + indexOffset);
+    m_entryCount = entryCount;
+    m_stringsOffset = stringsOffset;
+    qDebug() << "AssetPack mapped:" << m_filePath << "entries:" << m_entryCount << "bytes:" << m_dataSize;
+    return true;
+}
+
+bool AssetPack::isOpen() const {
+    return m_data != nullptr;
+}
+
+const QString& AssetPack::getFilePath() const {
+    return m_filePath;
+}
+
+QStringList AssetPack::getPaths() const {
+    QStringList paths;
+    paths.reserve(static_cast<qsizetype>(m_entryCount));
+    for (quint32 i = 0; i < m_entryCount; ++i) {
+        const QByteArrayView path = pathOf(m_index[i]);
+        if (!path.isEmpty()) {
+            paths.append(QString::fromUtf8(path));
+        }
+    }
+    return paths;
+}
+
+bool AssetPack::contains(QStringView path) const {
+    return findEntry(path) != nullptr;
+}
+
+QByteArray AssetPack::read(QStringView path) const {
+    const AssetPackFormat::IndexEntry* entry = findEntry(path);
+    if (entry == nullptr) {
+        return {};
+    }
+    const qint64 offset = static_cast<qint64>(entry->dataOffset);
+    const qint64 size = static_cast<qint64>(entry->dataSize);
+    if (offset < 0 || size < 0 || offset + size > m_dataSize) {
+        qWarning() << "AssetPack entry points outside the mapping:" << path;
+        return {};
+    }
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + offset), size);
+}
+
+AssetPackFormat::TypeHint AssetPack::getTypeHint(QStringView path) const {
+    const AssetPackFormat::IndexEntry* entry = findEntry(path);
+    if (entry == nullptr) {
+        return AssetPackFormat::TypeHint::Unknown;
+    }
+    return static_cast<AssetPackFormat::TypeHint>(static_cast<quint32>(entry->typeHint));
+}
+
+quint64 AssetPack::getContentHash(QStringView path) const {
+    const AssetPackFormat::IndexEntry* entry = findEntry(path);
+    return entry != nullptr ? static_cast<quint64>(entry->contentHash) : 0;
+}
+
+const AssetPackFormat::IndexEntry* AssetPack::findEntry(QStringView path) const {
+    if (!isOpen()) {
+        return nullptr;
+    }
+    const QByteArray utf8 = path.toUtf8();
+    const quint64 pathHash = AssetPackFormat::hash(utf8);
+    const AssetPackFormat::IndexEntry* end = m_index + m_entryCount;
+    const AssetPackFormat::IndexEntry* it = std::lower_bound(m_index, end, pathHash,
+        [](const AssetPackFormat::IndexEntry& entry, quint64 value) {
+            return static_cast<quint64>(entry.pathHash) < value;
+        });
+    // Hash collisions are adjacent in the sorted index; confirm by path.
+    for (; it != end && static_cast<quint64>(it->pathHash) == pathHash; ++it) {
+        const QByteArrayView stored = pathOf(*it);
+        if (stored.size() == utf8.size() && std::memcmp(stored.data(), utf8.constData(), utf8.size()) == 0) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+QByteArrayView AssetPack::pathOf(const AssetPackFormat::IndexEntry& entry) const {
+    const qint64 offset = m_stringsOffset + static_cast<qint64>(entry.pathOffset);
+    const qint64 length = static_cast<qint64>(entry.pathLength);
+    if (offset + length > m_dataSize) {
+        return {};
+    }
+    return QByteArrayView(reinterpret_cast<const char*>(m_data + offset), length);
+}
@@ -0,0 +1,210 @@
+#include "resources/DecodedImageCache.h"
+
+#include "core/Configuration.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHashFunctions>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include <cstring>
+
+namespace {
+constexpr qint64 BytesPerMegabyte = 1024 * 1024;
+constexpr int DefaultDiskCacheMb = 1024;
+constexpr char FileSuffix[] = ".gdic";
+constexpr char Magic[4] = { 'G', 'D', 'I', 'C' };
+constexpr quint32 Version = 1;
+
+// Machine-local cache: native endianness is fine.  Sized so pixel rows start
+// on a 64-byte boundary inside the mapping.
+struct DiskImageHeader {
+    char magic[4];
+    quint32 version;
+    qint32 width;
+    qint32 height;
+    qint32 bytesPerLine;
+    qint32 format;
+    quint8 reserved[40];
+};
+static_assert(sizeof(DiskImageHeader) == 64, "DiskImageHeader layout changed");
+
+void releaseMappedFile(void* info) {
+    // QFile's destructor unmaps every region it mapped.
+    delete static_cast<QFile*>(info);
+}
+}
+
+DecodedImageCache::DecodedImageCache()
+    : m_capBytes(DefaultDiskCacheMb * BytesPerMegabyte)
+    , m_diskBytes(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_writes(0)
+    , m_bytesSaved(0)
+{
+}
+
+DecodedImageCache& DecodedImageCache::getInstance() {
+    static DecodedImageCache instance;
+    return instance;
+}
+
+void DecodedImageCache::initialize() {
+    const Configuration& config = Configuration::getInstance();
+    const QString directory = config.getValue(QStringLiteral("resources.image_disk_cache_dir")).toString();
+    const int capMb = config.getValue(QStringLiteral("resources.image_disk_cache_mb"), DefaultDiskCacheMb).toInt();
+
+    QMutexLocker locker(&m_mutex);
+    m_capBytes = static_cast<qint64>(capMb) * BytesPerMegabyte;
+    m_directory.clear();
+    if (directory.isEmpty() || m_capBytes <= 0) {
+        return;
+    }
+    if (!QDir().mkpath(directory)) {
+        qWarning() << "DecodedImageCache cannot create directory:" << directory;
+        return;
+    }
+    m_directory = directory;
+    trimToCap();
+}
+
+bool DecodedImageCache::isEnabled() const {
+    QMutexLocker locker(&m_mutex);
+    return !m_directory.isEmpty();
+}
+
+QString DecodedImageCache::makeKey(const QByteArray& sourceBytes, qint64 sourceModifiedMs, const QSize& bounds) const {
+    // Fixed seed: the key has to be stable from one launch to the next.
+    const size_t contentHash = qHashBits(sourceBytes.constData(), static_cast<size_t>(sourceBytes.size()), 0);
+    return QStringLiteral("%1-%2-%3x%4")
+        .arg(static_cast<quint64>(contentHash), 16, 16, QLatin1Char('0'))
+        .arg(sourceModifiedMs, 0, 16)
+        .arg(bounds.isValid() ? bounds.width() : 0)
+        .arg(bounds.isValid() ? bounds.height() : 0);
+}
+
+QImage DecodedImageCache::load(const QString& key) {
+    const QString path = filePathForKey(key);
+    if (path.isEmpty()) {
+        return {};
+    }
+    auto* file = new QFile(path);
+    uchar* mapped = nullptr;
+    if (file->open(QIODevice::ReadOnly) && file->size() >= static_cast<qint64>(sizeof(DiskImageHeader))) {
+        mapped = file->map(0, file->size());
+    }
+    const auto* header = reinterpret_cast<const DiskImageHeader*>(mapped);
+    const bool valid = mapped != nullptr
+        && std::memcmp(header->magic, Magic, sizeof(Magic)) == 0
+        && header->version == Version
+        && header->width > 0 && header->height > 0
+        && header->format > QImage::Format_Invalid && header->format < QImage::NImageFormats
+        && file->size() == static_cast<qint64>(sizeof(DiskImageHeader))
+                           + static_cast<qint64>(header->bytesPerLine) * header->height;
+    if (!valid) {
+        delete file;
+        QMutexLocker locker(&m_mutex);
+        ++m_misses;
+        return {};
+    }
+
+    // Refresh the LRU timestamp used by startup trimming.
+    file->setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    // const uchar*: the mapping is read-only, so writers must detach to a copy.
+    const QImage image(static_cast<const uchar*>(mapped) + sizeof(DiskImageHeader), header->width, header->height, header->bytesPerLine,
+                       static_cast<QImage::Format>(header->format), releaseMappedFile, file);
+    QMutexLocker locker(&m_mutex);
+    ++m_hits;
+    m_bytesSaved += image.sizeInBytes();
+    return image;
+}
+
+void DecodedImageCache::store(const QString& key, const QImage& image) {
+    const QString path = filePathForKey(key);
+    if (path.isEmpty() || image.isNull()) {
+        return;
+    }
+    const qint64 entryBytes = static_cast<qint64>(sizeof(DiskImageHeader)) + image.sizeInBytes();
+    // Overwriting an entry (e.g. one that failed validation) replaces its bytes.
+    const QFileInfo previous(path);
+    const qint64 addedBytes = entryBytes - (previous.exists() ? previous.size() : 0);
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_diskBytes + addedBytes > m_capBytes) {
+            return;
+        }
+        m_diskBytes += addedBytes;
+    }
+
+    DiskImageHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.width = image.width();
+    header.height = image.height();
+    header.bytesPerLine = static_cast<qint32>(image.bytesPerLine());
+    header.format = static_cast<qint32>(image.format());
+
+    // QSaveFile keeps a half-written entry from ever being mapped by another launch.
+    QSaveFile file(path);
+    const bool written = file.open(QIODevice::WriteOnly)
+        && file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == static_cast<qint64>(sizeof(header))
+        && file.write(reinterpret_cast<const char*>(image.constBits()), image.sizeInBytes()) == image.sizeInBytes()
+        && file.commit();
+    QMutexLocker locker(&m_mutex);
+    if (!written) {
+        // QSaveFile left any previous entry in place.
+        m_diskBytes -= addedBytes;
+        qWarning() << "DecodedImageCache failed to write:" << path;
+        return;
+    }
+    ++m_writes;
+}
+
+DecodedImageCache::Stats DecodedImageCache::getStats() const {
+    QMutexLocker locker(&m_mutex);
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.writes = m_writes;
+    stats.bytesSaved = m_bytesSaved;
+    stats.diskBytes = m_diskBytes;
+    stats.capBytes = m_capBytes;
+    return stats;
+}
+
+void DecodedImageCache::trimToCap() {
+    const QDir directory(m_directory);
+    // Oldest first: hits refresh the modification time, so this is LRU order.
+    const QFileInfoList files = directory.entryInfoList(
+        { QStringLiteral("*") + QLatin1String(FileSuffix) }, QDir::Files, QDir::Time | QDir::Reversed);
+    qint64 totalBytes = 0;
+    for (const QFileInfo& info : files) {
+        totalBytes += info.size();
+    }
+    qint64 trimmedBytes = 0;
+    for (const QFileInfo& info : files) {
+        if (totalBytes <= m_capBytes) {
+            break;
+        }
+        if (QFile::remove(info.absoluteFilePath())) {
+            totalBytes -= info.size();
+            trimmedBytes += info.size();
+        }
+    }
+    m_diskBytes = totalBytes;
+    qDebug() << "DecodedImageCache:" << m_directory << "using" << m_diskBytes << "bytes, trimmed" << trimmedBytes;
+}
+
+QString DecodedImageCache::filePathForKey(const QString& key) const {
+    QMutexLocker locker(&m_mutex);
+    if (m_directory.isEmpty() || key.isEmpty()) {
+        return {};
+    }
+    return m_directory + QLatin1Char('/') + key + QLatin1String(FileSuffix);
+}
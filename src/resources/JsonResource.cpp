@@ -18,3 +18,13 @@ void JsonResource::setDataSize(size_t dataSize) {
     QWriteLocker lock(&m_lock);
     m_dataSize = dataSize;
 }
+
+QJsonDocument JsonResource::getDocument() const {
+    QReadLocker lock(&m_lock);
+    return m_document;
+}
+
+void JsonResource::setDocument(const QJsonDocument& document) {
+    QWriteLocker lock(&m_lock);
+    m_document = document;
+}
@@ -0,0 +1,156 @@
+#include "resources/LoadGroup.h"
+
+#include "resources/Loader.h"
+#include "resources/Resource.h"
+#include "resources/Resources.h"
+
+#include <QDebug>
+#include <QFuture>
+#include <QMetaObject>
+#include <QMutexLocker>
+
+LoadGroup::LoadGroup(const QStringList& names, Execution::Priority priority)
+    : QObject(nullptr)
+    , m_priority(priority)
+    , m_started(false)
+    , m_finished(false)
+    , m_progressPending(false)
+{
+    const Resources& resources = Resources::getInstance();
+    m_items.reserve(names.size());
+    for (const QString& name : names) {
+        Item item;
+        item.name = name;
+        item.loader = resources.getLoader(name);
+        item.bytes = resources.getSourceSize(name);
+        m_progress.totalBytes += item.bytes;
+        m_items.append(item);
+    }
+    m_progress.totalCount = static_cast<int>(m_items.size());
+}
+
+void LoadGroup::start() {
+    if (m_started) {
+        return;
+    }
+    m_started = true;
+
+    QString error;
+    for (const Item& item : std::as_const(m_items)) {
+        if (item.loader.isNull()) {
+            error = "LoadGroup has no loader for resource: " + item.name;
+            break;
+        }
+    }
+    if (!error.isEmpty() || m_items.isEmpty()) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_finished = true;
+            m_error = error;
+        }
+        QMetaObject::invokeMethod(this, &LoadGroup::publishFinished, Qt::QueuedConnection);
+        return;
+    }
+
+    const QSharedPointer<LoadGroup> self = sharedFromThis();
+    const int itemCount = static_cast<int>(m_items.size());
+    m_tokens.reserve(itemCount);
+    for (int index = 0; index < itemCount; ++index) {
+        CancellationToken token;
+        // Runs on the thread that finished the load; the group is kept alive
+        // until every continuation has run.
+        m_items.at(index).loader->requestLoad({}, m_priority, token)
+            .then(QtFuture::Launch::Sync, [self, index](const QSharedPointer<Resource>& resource) {
+                self->completeItem(index, !resource.isNull());
+            });
+        m_tokens.append(token);
+    }
+}
+
+void LoadGroup::cancel() {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_finished) {
+            return;
+        }
+        m_finished = true;
+        m_error = QStringLiteral("LoadGroup cancelled");
+    }
+    for (CancellationToken& token : m_tokens) {
+        token.cancel();
+    }
+    QMetaObject::invokeMethod(this, &LoadGroup::publishFinished, Qt::QueuedConnection);
+}
+
+LoadGroup::Progress LoadGroup::getProgress() const {
+    QMutexLocker locker(&m_mutex);
+    return m_progress;
+}
+
+bool LoadGroup::isFinished() const {
+    QMutexLocker locker(&m_mutex);
+    return m_finished;
+}
+
+void LoadGroup::completeItem(int index, bool loaded) {
+    bool postProgress = false;
+    bool postFinished = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_finished) {
+            return;
+        }
+        if (!loaded) {
+            m_finished = true;
+            m_error = "LoadGroup failed to load resource: " + m_items.at(index).name;
+            postFinished = true;
+        } else {
+            ++m_progress.loadedCount;
+            m_progress.loadedBytes += m_items.at(index).bytes;
+            if (m_progress.loadedCount == m_progress.totalCount) {
+                m_finished = true;
+                postFinished = true;
+            } else if (!m_progressPending) {
+                // Completions arriving before the group's thread gets to this
+                // update are folded into it.
+                m_progressPending = true;
+                postProgress = true;
+            }
+        }
+    }
+    if (postFinished) {
+        QMetaObject::invokeMethod(this, &LoadGroup::publishFinished, Qt::QueuedConnection);
+    } else if (postProgress) {
+        QMetaObject::invokeMethod(this, &LoadGroup::publishProgress, Qt::QueuedConnection);
+    }
+}
+
+void LoadGroup::publishProgress() {
+    Progress progress;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_progressPending = false;
+        progress = m_progress;
+    }
+    emit progressChanged(progress.loadedCount, progress.totalCount, progress.loadedBytes, progress.totalBytes);
+}
+
+void LoadGroup::publishFinished() {
+    Progress progress;
+    QString error;
+    {
+        QMutexLocker locker(&m_mutex);
+        progress = m_progress;
+        error = m_error;
+    }
+    const bool success = error.isEmpty();
+    if (!success) {
+        qWarning() << error;
+        // Whatever is still in flight is no longer wanted by this group.
+        for (CancellationToken& token : m_tokens) {
+            token.cancel();
+        }
+    }
+    emit progressChanged(progress.loadedCount, progress.totalCount, progress.loadedBytes, progress.totalBytes);
+    emit finished(success, error);
+}
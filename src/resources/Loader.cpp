@@ -1,27 +1,43 @@
 #include "resources/Loader.h"
 
+#include "core/Configuration.h"
 #include "core/Execution.h"
 #include "factory/Registration.h"
+#include "resources/AssetPack.h"
+#include "resources/DecodedImageCache.h"
 #include "resources/FormatSupport.h"
 #include "resources/JsonResource.h"
+#include "resources/MediaPlayerPool.h"
 #include "resources/MediaResource.h"
 #include "resources/QmlResource.h"
+#include "resources/ResourceCache.h"
+#include "resources/SoundBankResource.h"
+#include "resources/SoundEffects.h"
+#include "resources/Resources.h"
 #include "resources/TextureResource.h"
 
+#include <QAudioBuffer>
+#include <QAudioDecoder>
+#include <QBuffer>
+#include <QDateTime>
 #include <QDebug>
+#include <QEventLoop>
 #include <QFile>
 #include <QFileInfo>
+#include <QFuture>
 #include <QImage>
 #include <QImageReader>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QMediaPlayer>
 #include <QMetaObject>
 #include <QMutexLocker>
 #include <QPointer>
+#include <QPromise>
 #include <QUrl>
 
+#include <utility>
+
 namespace {
 QString normalizeQrcPath(const QString& path) {
     if (path.startsWith("qrc:/")) {
@@ -30,14 +46,123 @@ QString normalizeQrcPath(const QString& path) {
     return path;
 }
 
-QUrl toMediaUrl(const QString& path) {
-    if (path.startsWith("qrc:/")) {
-        return QUrl(path);
+constexpr int DefaultImageDecodeQuality = 75;
+constexpr int DefaultMaxSoundClipMs = 3000;
+
+QString variantKey(const QString& sourceUrl, const QSize& bounds) {
+    if (!bounds.isValid()) {
+        return sourceUrl;
+    }
+    return sourceUrl + QStringLiteral("@%1x%2").arg(bounds.width()).arg(bounds.height());
+}
+
+QSize configuredWindowSize() {
+    const Configuration& config = Configuration::getInstance();
+    return QSize(config.getValue(QStringLiteral("window.width")).toInt(),
+                 config.getValue(QStringLiteral("window.height")).toInt());
+}
+
+bool isPackUrl(const QString& path) {
+    return path.startsWith(QString::fromLatin1(AssetPack::Protocol) + QStringLiteral("://"));
+}
+
+qint64 sourceModifiedMs(const QString& sourceUrl) {
+    // qrc and pack contents are covered by their content hash alone.
+    if (isPackUrl(sourceUrl) || sourceUrl.startsWith("qrc:/") || sourceUrl.startsWith(":/")) {
+        return 0;
+    }
+    return QFileInfo(sourceUrl).lastModified().toMSecsSinceEpoch();
+}
+
+QImage decodeImage(const QString& sourceUrl, const QByteArray& sourceBytes, const QByteArray& format, const QSize& bounds,
+                   const CancellationToken& token) {
+    // QBuffer shares the QByteArray, so packed sources are decoded from the mapping in place.
+    QBuffer buffer;
+    buffer.setData(sourceBytes);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer, format);
+    // Decoding straight to the display size lets codecs take shortcuts (JPEG
+    // DCT scaling) instead of decoding full resolution and scaling afterwards.
+    const QSize sourceSize = reader.size();
+    if (bounds.isValid() && sourceSize.isValid()
+        && (sourceSize.width() > bounds.width() || sourceSize.height() > bounds.height())) {
+        reader.setScaledSize(sourceSize.scaled(bounds, Qt::KeepAspectRatio));
+        reader.setQuality(Configuration::getInstance()
+            .getValue(QStringLiteral("render.image_decode_quality"), DefaultImageDecodeQuality)
+            .toInt());
+    }
+    const QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "BitmapLoader failed to read image:" << sourceUrl << reader.errorString();
+        return {};
+    }
+    if (token.isCancelled()) {
+        return {};
+    }
+    return image;
+}
+
+QImage convertForUpload(const QImage& image) {
+    // Premultiplied is what the scene graph uploads, and what the disk cache stores.
+    return image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                         : QImage::Format_RGB32);
+}
+
+// Pack sources come straight from the mapping; everything else is read from disk/qrc.
+bool readSourceBytes(const QString& sourceUrl, QByteArray& data) {
+    if (isPackUrl(sourceUrl)) {
+        data = Resources::getInstance().readPackedResource(sourceUrl);
+        return !data.isNull();
     }
-    if (path.startsWith(":/")) {
-        return QUrl("qrc" + path);
+    QFile file(normalizeQrcPath(sourceUrl));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    data = file.readAll();
+    return true;
+}
+
+// Runs QAudioDecoder to completion on the calling worker; it only reports
+// through signals, so a local event loop drives it.
+QByteArray decodePcm(const QByteArray& sourceBytes, const QAudioFormat& format, qint64 maxDurationUs,
+                     const CancellationToken& token, QString& error) {
+    QBuffer buffer;
+    buffer.setData(sourceBytes);
+    buffer.open(QIODevice::ReadOnly);
+    QAudioDecoder decoder;
+    decoder.setAudioFormat(format);
+    decoder.setSourceDevice(&buffer);
+
+    QByteArray pcm;
+    QEventLoop loop;
+    QObject::connect(&decoder, &QAudioDecoder::bufferReady, &loop, [&]() {
+        const QAudioBuffer chunk = decoder.read();
+        pcm.append(chunk.constData<char>(), chunk.byteCount());
+        if (token.isCancelled()) {
+            error = QStringLiteral("cancelled");
+        } else if (format.durationForBytes(static_cast<qint32>(pcm.size())) > maxDurationUs) {
+            error = QStringLiteral("longer than the sound bank clip limit");
+        } else {
+            return;
+        }
+        decoder.stop();
+        loop.quit();
+    });
+    QObject::connect(&decoder, &QAudioDecoder::finished, &loop, &QEventLoop::quit);
+    QObject::connect(&decoder, qOverload<QAudioDecoder::Error>(&QAudioDecoder::error), &loop, [&]() {
+        error = decoder.errorString();
+        loop.quit();
+    });
+    decoder.start();
+    loop.exec();
+    return error.isEmpty() ? pcm : QByteArray();
+}
+
+QString resolveClipUrl(const QString& bankUrl, const QString& clipPath) {
+    if (clipPath.contains("://") || clipPath.startsWith(":/") || QFileInfo(clipPath).isAbsolute()) {
+        return clipPath;
     }
-    return QUrl::fromLocalFile(QFileInfo(path).absoluteFilePath());
+    return bankUrl.left(bankUrl.lastIndexOf('/') + 1) + clipPath;
 }
 
 QString resolveProtocol(const QString& source) {
@@ -80,6 +205,10 @@ QString Loader::getSourceUrl() const {
     return m_sourceUrl;
 }
 
+QString Loader::getCacheKey(const QVariant& source) const {
+    return cacheKey(source.isValid() ? source.toString() : getSourceUrl());
+}
+
 bool Loader::isInitialized() const {
     QMutexLocker locker(&m_initializedMutex);
     return m_initialized;
@@ -90,55 +219,219 @@ void Loader::markInitialized() {
     m_initialized = true;
 }
 
-Loader& Loader::load(const QVariant& source, bool async) {
+CancellationToken Loader::load(const QVariant& source, bool async, Execution::Priority priority) {
     const QString sourceUrl = source.isValid() ? source.toString() : getSourceUrl();
     if (sourceUrl.isEmpty()) {
         emit loadFailed("Loader source URL is empty for " + getProtocol() + ":" + getSuffix());
-        return *this;
+        return {};
     }
 
-    auto completeLoad = [sourceUrl](Loader* loader) {
-        if (!loader) {
-            return;
-        }
-
-        QSharedPointer<Resource> resource = loader->loadImpl(sourceUrl);
-        if (resource.isNull()) {
-            const QString errorMessage = "Loader failed to parse resource: " + sourceUrl;
-            QPointer<Loader> guarded(loader);
-            QMetaObject::invokeMethod(loader, [guarded, errorMessage]() {
+    const QString key = cacheKey(sourceUrl);
+    CancellationToken token;
+    QFuture<QSharedPointer<Resource>> future = startLoad(sourceUrl, key, async, priority, token);
+    if (async) {
+        QPointer<Loader> guarded(this);
+        // Published through the frame-budgeted main-thread queue so a burst of
+        // completions does not run in a single event-loop turn.
+        future.then(QtFuture::Launch::Sync, [guarded, sourceUrl, key](const QSharedPointer<Resource>& resource) {
+            Execution::getInstance().dispatchMainThreadTask([guarded, sourceUrl, key, resource]() {
                 if (guarded) {
-                    emit guarded->loadFailed(errorMessage);
+                    guarded->completeLoad(sourceUrl, key, resource);
                 }
-            }, Qt::QueuedConnection);
-            return;
+            });
+        });
+    } else {
+        future.waitForFinished();
+        if (!future.isCanceled()) {
+            completeLoad(sourceUrl, key, future.result());
         }
+    }
+    return token;
+}
 
-        {
-            QMutexLocker locker(&loader->m_resourceMutex);
-            loader->cacheResource(sourceUrl, resource);
-        }
-        loader->markInitialized();
-        QPointer<Loader> guarded(loader);
-        QMetaObject::invokeMethod(loader, [guarded]() {
-            if (guarded) {
-                emit guarded->loadFinished(guarded.data());
+QFuture<QSharedPointer<Resource>> Loader::requestLoad(const QVariant& source, Execution::Priority priority,
+                                                      CancellationToken& token) {
+    const QString sourceUrl = source.isValid() ? source.toString() : getSourceUrl();
+    if (sourceUrl.isEmpty()) {
+        QPromise<QSharedPointer<Resource>> failed;
+        failed.start();
+        failed.addResult(QSharedPointer<Resource>());
+        failed.finish();
+        return failed.future();
+    }
+    const QString key = cacheKey(sourceUrl);
+    QPointer<Loader> guarded(this);
+    return startLoad(sourceUrl, key, true, priority, token)
+        .then(QtFuture::Launch::Sync, [guarded, key](const QSharedPointer<Resource>& resource) {
+            if (guarded && !resource.isNull()) {
+                guarded->recordLoad(key, resource);
             }
-        }, Qt::QueuedConnection);
-    };
+            return resource;
+        });
+}
 
-    if (async) {
+QSharedPointer<Resource> Loader::loadSync(const QVariant& source) {
+    const QString sourceUrl = source.isValid() ? source.toString() : getSourceUrl();
+    if (sourceUrl.isEmpty()) {
+        return {};
+    }
+    const QString key = cacheKey(sourceUrl);
+    CancellationToken token;
+    QFuture<QSharedPointer<Resource>> future = startLoad(sourceUrl, key, false, Execution::Priority::Immediate, token);
+    future.waitForFinished();
+    if (future.isCanceled()) {
+        return {};
+    }
+    const QSharedPointer<Resource> resource = future.result();
+    if (!resource.isNull()) {
+        recordLoad(key, resource);
+    }
+    return resource;
+}
+
+AsyncTask<QSharedPointer<Resource>> Loader::loadAsync(QVariant source, Execution::Priority priority) {
+    const QString sourceUrl = source.isValid() ? source.toString() : getSourceUrl();
+    if (!sourceUrl.isEmpty()) {
+        // A cache hit completes without a trip through the pool and the main-thread queue.
+        const QSharedPointer<Resource> cached = findCachedResource(sourceUrl);
+        if (!cached.isNull()) {
+            recordLoad(cacheKey(sourceUrl), cached);
+            co_return cached;
+        }
+    }
+    CancellationToken token;
+    co_return co_await awaitFuture(requestLoad(source, priority, token));
+}
+
+QFuture<QSharedPointer<Resource>> Loader::startLoad(const QString& sourceUrl, const QString& key, bool async,
+                                                    Execution::Priority priority, CancellationToken& token) {
+    ResourceCache& cache = ResourceCache::getInstance();
+    auto promise = QSharedPointer<QPromise<QSharedPointer<Resource>>>::create();
+    QFuture<QSharedPointer<Resource>> future = promise->future();
+    token = CancellationToken::create();
+    const bool coalesced = cache.attachPendingLoad(key, future, token, priority == Execution::Priority::Prefetch);
+    if (!coalesced) {
+        promise->start();
         QPointer<Loader> self(this);
-        Execution::getInstance().dispatchAsyncTask([self, completeLoad]() {
-            if (!self) {
+        // If Execution drops this task unrun, destroying the last promise
+        // reference cancels the future and the stale pending entry is replaced
+        // by the next attachPendingLoad().
+        auto publishLoad = [key, promise, token](const QSharedPointer<Resource>& resource) {
+            ResourceCache& resourceCache = ResourceCache::getInstance();
+            if (resource.isNull() && token.isCancelled()) {
+                resourceCache.finishPendingLoad(key, token);
+                resourceCache.recordCancelledLoad();
+                promise->future().cancel();
+                promise->finish();
                 return;
             }
-            completeLoad(self.data());
-        });
+            // Publish to the cache before leaving the pending table so a concurrent
+            // caller always sees either the cached result or the pending load.
+            resourceCache.publishPendingLoad(key, token, resource);
+            promise->addResult(resource);
+            promise->finish();
+        };
+        auto runLoad = [self, sourceUrl, token, publishLoad]() {
+            QSharedPointer<Resource> resource;
+            if (self && !token.isCancelled()) {
+                resource = self->loadImpl(sourceUrl, token);
+            }
+            publishLoad(resource);
+        };
+        TaskGraph graph;
+        std::function<QSharedPointer<Resource>()> result;
+        const TaskGraph::Node lastStage = async ? buildLoadGraph(graph, sourceUrl, token, result) : -1;
+        if (lastStage >= 0) {
+            auto published = QSharedPointer<QAtomicInt>::create(0);
+            graph.precede(lastStage, graph.add([result, publishLoad, published]() {
+                if (published->testAndSetOrdered(0, 1)) {
+                    publishLoad(result());
+                }
+            }));
+            // Cancelled stages drop the publishing one too; finish the load here then.
+            QList<quint64> rootTaskIds;
+            Execution::getInstance().runGraph(std::move(graph), priority, token, &rootTaskIds)
+                .onCanceled([publishLoad, published]() {
+                    if (published->testAndSetOrdered(0, 1)) {
+                        publishLoad({});
+                    }
+                });
+            // Raising the first stage is what matters: later ones start as it finishes.
+            if (!rootTaskIds.isEmpty()) {
+                cache.setPendingTaskId(key, rootTaskIds.constFirst());
+            }
+        } else if (async) {
+            cache.setPendingTaskId(key, Execution::getInstance().dispatchAsyncTask(runLoad, priority, token));
+        } else {
+            runLoad();
+        }
     } else {
-        completeLoad(this);
+        raisePriority(async ? priority : Execution::Priority::Immediate, sourceUrl);
     }
-    return *this;
+    return future;
+}
+
+bool Loader::raisePriority(Execution::Priority priority, const QVariant& source) {
+    const QString sourceUrl = source.isValid() ? source.toString() : getSourceUrl();
+    const quint64 taskId = ResourceCache::getInstance().getPendingTaskId(cacheKey(sourceUrl));
+    return taskId != 0 && Execution::getInstance().raiseTaskPriority(taskId, priority);
+}
+
+void Loader::completeLoad(const QString& sourceUrl, const QString& key, const QSharedPointer<Resource>& resource) {
+    if (resource.isNull()) {
+        emit loadFailed("Loader failed to parse resource: " + sourceUrl);
+        return;
+    }
+    recordLoad(key, resource);
+    emit loadFinished(this);
+}
+
+void Loader::recordLoad(const QString& key, const QSharedPointer<Resource>& resource) {
+    {
+        QMutexLocker locker(&m_resourceMutex);
+        cacheResource(key, resource);
+    }
+    markInitialized();
+}
+
+CancellationToken Loader::reload(Execution::Priority priority) {
+    const QString sourceUrl = getSourceUrl();
+    if (sourceUrl.isEmpty() || !isInitialized()) {
+        return {};
+    }
+    QSharedPointer<Resource> previous;
+    {
+        QMutexLocker locker(&m_resourceMutex);
+        // Holding the old payload keeps m_lastResource (and getCachedResource()) valid while
+        // the cache no longer serves it.
+        previous = m_lastResource.toStrongRef();
+        ResourceCache& cache = ResourceCache::getInstance();
+        for (const QString& key : std::as_const(m_cachedUrls)) {
+            cache.remove(key);
+        }
+        m_cachedUrls.clear();
+    }
+
+    const QString key = cacheKey(sourceUrl);
+    CancellationToken token;
+    QPointer<Loader> guarded(this);
+    startLoad(sourceUrl, key, true, priority, token)
+        .then(QtFuture::Launch::Sync, [guarded, sourceUrl, key, previous](const QSharedPointer<Resource>& resource) {
+            Execution::getInstance().dispatchMainThreadTask([guarded, sourceUrl, key, previous, resource]() {
+                if (!guarded) {
+                    return;
+                }
+                if (resource.isNull() && !previous.isNull()) {
+                    // Typically a half-written file; keep serving the last good version.
+                    qWarning() << "Reload failed, keeping previous version:" << sourceUrl;
+                    ResourceCache::getInstance().insert(key, previous);
+                    guarded->recordLoad(key, previous);
+                    return;
+                }
+                guarded->completeLoad(sourceUrl, key, resource);
+            });
+        });
+    return token;
 }
 
 Loader& Loader::unload(bool async) {
@@ -150,7 +443,11 @@ Loader& Loader::unload(bool async) {
         loader->unloadImpl();
         {
             QMutexLocker locker(&loader->m_resourceMutex);
-            loader->m_resourceCache.clear();
+            ResourceCache& cache = ResourceCache::getInstance();
+            for (const QString& url : std::as_const(loader->m_cachedUrls)) {
+                cache.remove(url);
+            }
+            loader->m_cachedUrls.clear();
             loader->m_lastResource.clear();
         }
         {
@@ -172,39 +469,45 @@ Loader& Loader::unload(bool async) {
                 return;
             }
             completeUnload(self.data());
-        });
+        }, Execution::Priority::Background);
     } else {
         completeUnload(this);
     }
     return *this;
 }
 
-QObject* Loader::get() const {
-    QMutexLocker locker(&m_resourceMutex);
-    if (m_lastResource.isNull()) {
-        return nullptr;
-    }
-    return m_lastResource->get();
+void Loader::unloadImpl() {
 }
 
-void Loader::unloadImpl() {
+QString Loader::cacheKey(const QString& sourceUrl) const {
+    return sourceUrl;
 }
 
-void Loader::cacheResource(const QString& sourceUrl, const QSharedPointer<Resource>& resource) {
-    if (sourceUrl.isEmpty() || resource.isNull()) {
+TaskGraph::Node Loader::buildLoadGraph(TaskGraph& graph, const QString& sourceUrl, const CancellationToken& token,
+                                       std::function<QSharedPointer<Resource>()>& result) {
+    Q_UNUSED(graph);
+    Q_UNUSED(sourceUrl);
+    Q_UNUSED(token);
+    Q_UNUSED(result);
+    return -1;
+}
+
+void Loader::cacheResource(const QString& key, const QSharedPointer<Resource>& resource) {
+    if (key.isEmpty() || resource.isNull()) {
         return;
     }
-    m_resourceCache[sourceUrl] = resource;
+    // startLoad() already published it to the cache.
+    m_cachedUrls.insert(key);
     m_lastResource = resource;
 }
 
 QSharedPointer<Resource> Loader::findCachedResource(const QString& sourceUrl) const {
-    return m_resourceCache.value(sourceUrl);
+    return ResourceCache::getInstance().find(cacheKey(sourceUrl));
 }
 
 QSharedPointer<Resource> Loader::getCachedResource() const {
     QMutexLocker locker(&m_resourceMutex);
-    return m_lastResource;
+    return m_lastResource.toStrongRef();
 }
 
 QList<QSharedPointer<Loader>> Loader::getGeneratedLoaders() const {
@@ -219,72 +522,201 @@ void Loader::setGeneratedLoaders(const QList<QSharedPointer<Loader>>& loaders) {
 
 BitmapLoader::BitmapLoader(QObject* parent)
     : Loader("resource", "image", parent)
+    , m_targetSize(configuredWindowSize())
 {
 }
 
-QSharedPointer<Resource> BitmapLoader::loadImpl(const QString& sourceUrl) {
-    const QString pathSuffix = QFileInfo(sourceUrl).suffix().toLower();
-    if (pathSuffix.isEmpty()) {
-        qWarning() << "BitmapLoader requires file extension to detect image format:" << sourceUrl;
+QSize BitmapLoader::getTargetSize() const {
+    QMutexLocker locker(&m_targetSizeMutex);
+    return m_targetSize;
+}
+
+void BitmapLoader::setTargetSize(const QSize& targetSize) {
+    QMutexLocker locker(&m_targetSizeMutex);
+    m_targetSize = targetSize;
+}
+
+QString BitmapLoader::cacheKey(const QString& sourceUrl) const {
+    return variantKey(sourceUrl, getTargetSize());
+}
+
+QSharedPointer<Resource> BitmapLoader::findLargerVariant(const QString& sourceUrl, const QSize& bounds) const {
+    if (!bounds.isValid()) {
         return {};
     }
+    // Only the window-sized and full-resolution variants are probed: they are
+    // the ones other requesters produce by default.
+    ResourceCache& cache = ResourceCache::getInstance();
+    const QSize windowSize = configuredWindowSize();
+    if (windowSize.isValid() && windowSize != bounds
+        && windowSize.width() >= bounds.width() && windowSize.height() >= bounds.height()) {
+        const QString windowKey = variantKey(sourceUrl, windowSize);
+        if (cache.contains(windowKey)) {
+            QSharedPointer<Resource> resource = cache.find(windowKey);
+            if (!resource.isNull()) {
+                return resource;
+            }
+        }
+    }
+    if (cache.contains(sourceUrl)) {
+        return cache.find(sourceUrl);
+    }
+    return {};
+}
+
+// One bitmap load, carried from stage to stage.
+struct BitmapLoader::Load {
+    QString sourceUrl;
+    QByteArray format;
+    QSize bounds;
+    QByteArray sourceBytes;
+    QString diskKey;
+    QImage image;
+    bool converted = false;
+    // Set by any stage that ends the load early, or by the last one.
+    bool done = false;
+    QSharedPointer<Resource> result;
+};
+
+QSharedPointer<Resource> BitmapLoader::loadImpl(const QString& sourceUrl, const CancellationToken& token) {
+    Load load;
+    load.sourceUrl = sourceUrl;
+    readStage(load, token);
+    decodeStage(load, token);
+    convertStage(load, token);
+    return load.result;
+}
+
+TaskGraph::Node BitmapLoader::buildLoadGraph(TaskGraph& graph, const QString& sourceUrl, const CancellationToken& token,
+                                             std::function<QSharedPointer<Resource>()>& result) {
+    // Each stage is released onto the worker that finished the one before, so
+    // the bytes and pixels stay in that core's caches; other loads' stages
+    // fill the remaining workers.
+    const QSharedPointer<Load> load = QSharedPointer<Load>::create();
+    load->sourceUrl = sourceUrl;
+    QPointer<BitmapLoader> self(this);
+    const TaskGraph::Node read = graph.add([self, load, token]() {
+        if (self) {
+            self->readStage(*load, token);
+        } else {
+            load->done = true;
+        }
+    });
+    const TaskGraph::Node decode = graph.add([load, token]() {
+        decodeStage(*load, token);
+    });
+    const TaskGraph::Node convert = graph.add([load, token]() {
+        convertStage(*load, token);
+    });
+    graph.precede(read, decode);
+    graph.precede(decode, convert);
+    result = [load]() {
+        return load->result;
+    };
+    return convert;
+}
+
+void BitmapLoader::readStage(Load& load, const CancellationToken& token) const {
+    load.done = true;
+    const QString pathSuffix = QFileInfo(load.sourceUrl).suffix().toLower();
+    if (pathSuffix.isEmpty()) {
+        qWarning() << "BitmapLoader requires file extension to detect image format:" << load.sourceUrl;
+        return;
+    }
     if (!supportedImageSuffixes().contains(pathSuffix)) {
         qWarning() << "BitmapLoader unsupported image suffix:" << pathSuffix;
-        return {};
+        return;
     }
 
-    QSharedPointer<Resource> cached = findCachedResource(sourceUrl);
-    if (!cached.isNull()) {
-        return cached;
+    load.format = pathSuffix.toLatin1();
+    load.bounds = getTargetSize();
+    load.result = findCachedResource(load.sourceUrl);
+    if (load.result.isNull()) {
+        load.result = findLargerVariant(load.sourceUrl, load.bounds);
+    }
+    if (!load.result.isNull()) {
+        return;
     }
 
-    const QString qrcPath = normalizeQrcPath(sourceUrl);
-    QImageReader reader(qrcPath);
-    QImage image = reader.read();
-    if (image.isNull()) {
-        qWarning() << "BitmapLoader failed to read image:" << sourceUrl << reader.errorString();
-        return {};
+    if (!readSourceBytes(load.sourceUrl, load.sourceBytes)) {
+        qWarning() << "BitmapLoader failed to open:" << load.sourceUrl;
+        return;
     }
 
-    auto textureResource = QSharedPointer<TextureResource>::create(sourceUrl);
-    textureResource->setDimensions(image.width(), image.height());
+    if (token.isCancelled()) {
+        return;
+    }
+
+    DecodedImageCache& diskCache = DecodedImageCache::getInstance();
+    if (diskCache.isEnabled()) {
+        load.diskKey = diskCache.makeKey(load.sourceBytes, sourceModifiedMs(load.sourceUrl), load.bounds);
+        load.image = diskCache.load(load.diskKey);
+        // Disk cache entries are stored converted.
+        load.converted = !load.image.isNull();
+    }
+    load.done = false;
+}
+
+void BitmapLoader::decodeStage(Load& load, const CancellationToken& token) {
+    if (load.done || !load.image.isNull()) {
+        return;
+    }
+    load.image = decodeImage(load.sourceUrl, load.sourceBytes, load.format, load.bounds, token);
+    // The encoded bytes are not needed past this point.
+    load.sourceBytes.clear();
+    load.done = load.image.isNull();
+}
+
+void BitmapLoader::convertStage(Load& load, const CancellationToken& token) {
+    if (load.done) {
+        return;
+    }
+    load.done = true;
+    if (!load.converted) {
+        if (token.isCancelled()) {
+            return;
+        }
+        load.image = convertForUpload(load.image);
+        if (!load.diskKey.isEmpty()) {
+            DecodedImageCache::getInstance().store(load.diskKey, load.image);
+        }
+    }
+
+    auto textureResource = QSharedPointer<TextureResource>::create(load.sourceUrl);
+    textureResource->setImage(load.image);
     textureResource->setState(Resource::State::Loaded);
-    // Payload object is intentionally parentless and owned by Resource's shared pointer.
-    QObject* payload = new QObject();
-    payload->setProperty("image", image);
-    textureResource->set(payload);
-    qDebug() << "BitmapLoader loaded image:" << sourceUrl << "size:" << image.size();
-    return textureResource;
+    qDebug() << "BitmapLoader loaded image:" << load.sourceUrl << "size:" << load.image.size();
+    load.result = textureResource;
 }
 
 VideoLoader::VideoLoader(QObject* parent)
     : Loader("resource", "media", parent)
-    , m_mediaPlayer(new QMediaPlayer(this))
 {
 }
 
-QSharedPointer<Resource> VideoLoader::loadImpl(const QString& sourceUrl) {
+QSharedPointer<Resource> VideoLoader::loadImpl(const QString& sourceUrl, const CancellationToken& token) {
+    Q_UNUSED(token);
     QSharedPointer<Resource> cached = findCachedResource(sourceUrl);
     if (!cached.isNull()) {
         return cached;
     }
 
+    if (isPackUrl(sourceUrl)) {
+        // The multimedia backend needs a URL it can open itself; packed media is not playable.
+        qWarning() << "VideoLoader cannot stream media from an asset pack:" << sourceUrl;
+        return {};
+    }
     if (!sourceUrl.startsWith("qrc:/") && !sourceUrl.startsWith(":/") && !QFileInfo::exists(sourceUrl)) {
         qWarning() << "VideoLoader source file does not exist:" << sourceUrl;
         return {};
     }
 
-    const QUrl mediaUrl = toMediaUrl(sourceUrl);
-    m_mediaPlayer->setSource(mediaUrl);
-
+    // Players come from MediaPlayerPool when an item plays; the resource only
+    // records the source they will open.
     auto videoResource = QSharedPointer<MediaResource>::create(sourceUrl);
     videoResource->setDataSize(0);
     videoResource->setState(Resource::State::Loaded);
-    // Payload object is intentionally parentless and owned by Resource's shared pointer.
-    QObject* payload = new QObject();
-    payload->setProperty("url", mediaUrl);
-    videoResource->set(payload);
-    qDebug() << "VideoLoader prepared media source:" << mediaUrl;
+    qDebug() << "VideoLoader prepared media source:" << MediaPlayerPool::toMediaUrl(sourceUrl);
     return videoResource;
 }
 
@@ -293,20 +725,20 @@ JsonLoader::JsonLoader(QObject* parent)
 {
 }
 
-QSharedPointer<Resource> JsonLoader::loadImpl(const QString& sourceUrl) {
+QSharedPointer<Resource> JsonLoader::loadImpl(const QString& sourceUrl, const CancellationToken& token) {
     QSharedPointer<Resource> cached = findCachedResource(sourceUrl);
     if (!cached.isNull()) {
         return cached;
     }
 
-    QFile file(normalizeQrcPath(sourceUrl));
-    if (!file.open(QIODevice::ReadOnly)) {
+    QByteArray data;
+    if (!readSourceBytes(sourceUrl, data)) {
         qWarning() << "JsonLoader failed to open:" << sourceUrl;
         return {};
     }
-
-    const QByteArray data = file.readAll();
-    file.close();
+    if (token.isCancelled()) {
+        return {};
+    }
     QJsonParseError parseError;
     const QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
     if (parseError.error != QJsonParseError::NoError) {
@@ -341,38 +773,84 @@ QSharedPointer<Resource> JsonLoader::loadImpl(const QString& sourceUrl) {
 
     auto jsonResource = QSharedPointer<JsonResource>::create(sourceUrl);
     jsonResource->setDataSize(static_cast<size_t>(data.size()));
+    jsonResource->setDocument(doc);
     jsonResource->setState(Resource::State::Loaded);
-    // Payload object is intentionally parentless and owned by Resource's shared pointer.
-    QObject* payload = new QObject();
-    payload->setProperty("json", doc.toJson(QJsonDocument::Compact));
-    jsonResource->set(payload);
     return jsonResource;
 }
 
+SoundBankLoader::SoundBankLoader(QObject* parent)
+    : Loader("resource", "soundbank", parent)
+{
+}
+
+QSharedPointer<Resource> SoundBankLoader::loadImpl(const QString& sourceUrl, const CancellationToken& token) {
+    QSharedPointer<Resource> cached = findCachedResource(sourceUrl);
+    if (!cached.isNull()) {
+        return cached;
+    }
+
+    QByteArray data;
+    if (!readSourceBytes(sourceUrl, data)) {
+        qWarning() << "SoundBankLoader failed to open:" << sourceUrl;
+        return {};
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        qWarning() << "SoundBankLoader parse error:" << sourceUrl << parseError.errorString();
+        return {};
+    }
+
+    const QAudioFormat format = SoundEffects::getInstance().getFormat();
+    const qint64 maxDurationUs = static_cast<qint64>(Configuration::getInstance()
+        .getValue(QStringLiteral("audio.sound_bank_max_clip_ms"), DefaultMaxSoundClipMs)
+        .toInt()) * 1000;
+    auto bank = QSharedPointer<SoundBankResource>::create(sourceUrl);
+    const QJsonObject clips = doc.object().value("clips").toObject();
+    for (auto it = clips.begin(); it != clips.end(); ++it) {
+        if (token.isCancelled()) {
+            return {};
+        }
+        const QString clipUrl = resolveClipUrl(sourceUrl, it.value().toString());
+        QByteArray clipBytes;
+        if (!readSourceBytes(clipUrl, clipBytes)) {
+            qWarning() << "SoundBankLoader failed to open clip:" << clipUrl;
+            continue;
+        }
+        QString error;
+        const QByteArray pcm = decodePcm(clipBytes, format, maxDurationUs, token, error);
+        if (pcm.isEmpty()) {
+            qWarning() << "SoundBankLoader skipped clip" << it.key() << "(" << clipUrl << "):" << error;
+            continue;
+        }
+        bank->addClip(it.key(), pcm);
+    }
+    bank->setState(Resource::State::Loaded);
+    qDebug() << "SoundBankLoader loaded bank:" << sourceUrl << bank->getClipNames().size() << "clips,"
+             << bank->getSize() << "bytes PCM";
+    return bank;
+}
+
 QmlLoader::QmlLoader(QObject* parent)
     : Loader("resource", "qml", parent)
 {
 }
 
-QSharedPointer<Resource> QmlLoader::loadImpl(const QString& sourceUrl) {
+QSharedPointer<Resource> QmlLoader::loadImpl(const QString& sourceUrl, const CancellationToken& token) {
+    Q_UNUSED(token);
     QSharedPointer<Resource> cached = findCachedResource(sourceUrl);
     if (!cached.isNull()) {
         return cached;
     }
 
-    QFile file(normalizeQrcPath(sourceUrl));
-    if (!file.open(QIODevice::ReadOnly)) {
+    QByteArray data;
+    if (!readSourceBytes(sourceUrl, data)) {
         qWarning() << "QmlLoader failed to open:" << sourceUrl;
         return {};
     }
-    const QByteArray data = file.readAll();
-    file.close();
 
     auto qmlResource = QSharedPointer<QmlResource>::create(sourceUrl);
-    qmlResource->setDataSize(static_cast<size_t>(data.size()));
+    qmlResource->setData(data);
     qmlResource->setState(Resource::State::Loaded);
-    QObject* payload = new QObject();
-    payload->setProperty("qml", QString::fromUtf8(data));
-    qmlResource->set(payload);
     return qmlResource;
 }
@@ -0,0 +1,106 @@
+#include "resources/MediaPlayerPool.h"
+
+#include "core/Configuration.h"
+
+#include <QAudioOutput>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileInfo>
+#include <QMediaPlayer>
+
+namespace {
+constexpr int DefaultPlayerPoolSize = 2;
+}
+
+MediaPlayerPool::MediaPlayerPool()
+    : QObject(nullptr)
+    , m_capacity(DefaultPlayerPoolSize)
+    , m_createdCount(0)
+    , m_checkouts(0)
+    , m_exhausted(0)
+{
+}
+
+MediaPlayerPool& MediaPlayerPool::getInstance() {
+    static MediaPlayerPool instance;
+    return instance;
+}
+
+void MediaPlayerPool::initialize() {
+    m_capacity = qMax(1, Configuration::getInstance()
+        .getValue(QStringLiteral("media.player_pool_size"), DefaultPlayerPoolSize)
+        .toInt());
+    // Players must go before the application object takes the backend down.
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+            this, &MediaPlayerPool::clear, Qt::UniqueConnection);
+}
+
+QMediaPlayer* MediaPlayerPool::acquire() {
+    QMediaPlayer* player = nullptr;
+    if (!m_idlePlayers.isEmpty()) {
+        player = m_idlePlayers.takeLast();
+    } else if (m_players.size() < m_capacity) {
+        player = createPlayer();
+    } else {
+        ++m_exhausted;
+        qWarning() << "MediaPlayerPool exhausted; all" << m_capacity << "players are playing";
+        return nullptr;
+    }
+    ++m_checkouts;
+    return player;
+}
+
+void MediaPlayerPool::release(QMediaPlayer* player) {
+    if (player == nullptr || !m_players.contains(player) || m_idlePlayers.contains(player)) {
+        return;
+    }
+    player->stop();
+    player->setSource(QUrl());
+    player->setVideoOutput(nullptr);
+    player->setLoops(1);
+    m_idlePlayers.append(player);
+}
+
+void MediaPlayerPool::prewarm() {
+    int createdCount = 0;
+    while (m_players.size() < m_capacity) {
+        m_idlePlayers.append(createPlayer());
+        ++createdCount;
+    }
+    if (createdCount > 0) {
+        qDebug() << "MediaPlayerPool pre-warmed" << createdCount << "players";
+    }
+}
+
+void MediaPlayerPool::clear() {
+    qDeleteAll(m_players);
+    m_players.clear();
+    m_idlePlayers.clear();
+}
+
+MediaPlayerPool::Stats MediaPlayerPool::getStats() const {
+    Stats stats;
+    stats.created = m_createdCount;
+    stats.idle = static_cast<int>(m_idlePlayers.size());
+    stats.checkouts = m_checkouts;
+    stats.exhausted = m_exhausted;
+    return stats;
+}
+
+QUrl MediaPlayerPool::toMediaUrl(const QString& path) {
+    if (path.startsWith("qrc:/")) {
+        return QUrl(path);
+    }
+    if (path.startsWith(":/")) {
+        return QUrl("qrc" + path);
+    }
+    return QUrl::fromLocalFile(QFileInfo(path).absoluteFilePath());
+}
+
+QMediaPlayer* MediaPlayerPool::createPlayer() {
+    auto* player = new QMediaPlayer(this);
+    player->setAudioOutput(new QAudioOutput(player));
+    m_players.append(player);
+    ++m_createdCount;
+    return player;
+}
@@ -5,16 +5,20 @@
 
 QmlResource::QmlResource(const QString& url)
     : Resource(url)
-    , m_dataSize(0)
 {
 }
 
 size_t QmlResource::getSize() const {
     QReadLocker lock(&m_lock);
-    return m_dataSize;
+    return static_cast<size_t>(m_data.size());
 }
 
-void QmlResource::setDataSize(size_t dataSize) {
+QByteArray QmlResource::getData() const {
+    QReadLocker lock(&m_lock);
+    return m_data;
+}
+
+void QmlResource::setData(const QByteArray& data) {
     QWriteLocker lock(&m_lock);
-    m_dataSize = dataSize;
+    m_data = data;
 }
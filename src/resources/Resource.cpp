@@ -6,19 +6,16 @@
 Resource::Resource(const QString& url)
     : m_url(url)
     , m_state(State::Unloaded)
-    , m_object()
 {
 }
 
 Resource::Resource(const Resource& other)
     : m_url()
     , m_state(State::Unloaded)
-    , m_object()
 {
     QWriteLocker lock(&other.m_lock);
     m_url = other.m_url;
     m_state = other.m_state;
-    m_object = other.m_object;
 }
 
 Resource& Resource::operator=(const Resource& other) {
@@ -33,7 +30,6 @@ Resource& Resource::operator=(const Resource& other) {
 
     m_url = other.m_url;
     m_state = other.m_state;
-    m_object = other.m_object;
 
     second->m_lock.unlock();
     first->m_lock.unlock();
@@ -43,13 +39,11 @@ Resource& Resource::operator=(const Resource& other) {
 Resource::Resource(Resource&& other) noexcept
     : m_url()
     , m_state(State::Unloaded)
-    , m_object()
 {
     // Destination object is still under construction and not yet published to other threads.
     QWriteLocker lock(&other.m_lock);
     m_url = other.m_url;
     m_state = other.m_state;
-    m_object = other.m_object;
 }
 
 Resource& Resource::operator=(Resource&& other) noexcept {
@@ -64,7 +58,6 @@ Resource& Resource::operator=(Resource&& other) noexcept {
 
     m_url = other.m_url;
     m_state = other.m_state;
-    m_object = other.m_object;
 
     second->m_lock.unlock();
     first->m_lock.unlock();
@@ -93,20 +86,9 @@ bool Resource::isLoaded() const {
 void Resource::unload() {
     QWriteLocker lock(&m_lock);
     m_state = State::Unloaded;
-    m_object.clear();
 }
 
 void Resource::setState(State state) {
     QWriteLocker lock(&m_lock);
     m_state = state;
 }
-
-QObject* Resource::get() const {
-    QReadLocker lock(&m_lock);
-    return m_object.data();
-}
-
-void Resource::set(QObject* object) {
-    QWriteLocker lock(&m_lock);
-    m_object.reset(object);
-}
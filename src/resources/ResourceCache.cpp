@@ -0,0 +1,362 @@
+#include "resources/ResourceCache.h"
+
+#include "core/Configuration.h"
+#include "core/Execution.h"
+#include "resources/Resource.h"
+#include "resources/TextureResource.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+#include <iterator>
+
+namespace {
+constexpr qint64 BytesPerMegabyte = 1024 * 1024;
+constexpr int DefaultCacheBudgetMb = 512;
+constexpr int DefaultIdleGraceSeconds = 120;
+constexpr int MinIdleSweepIntervalMs = 1000;
+// Sweeping a few times per grace period bounds how far past it an entry lingers.
+constexpr int IdleSweepsPerGracePeriod = 4;
+}
+
+ResourceCache::ResourceCache()
+    : m_nextTick(0)
+    , m_budgetBytes(DefaultCacheBudgetMb * BytesPerMegabyte)
+    , m_usedBytes(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+    , m_coalescedLoads(0)
+    , m_cancelledLoads(0)
+    , m_idleGraceMs(static_cast<qint64>(DefaultIdleGraceSeconds) * 1000)
+    , m_idleEvictions(0)
+{
+    m_clock.start();
+    QObject::connect(&m_idleSweepTimer, &QTimer::timeout, &m_idleSweepTimer, []() {
+        Execution::getInstance().dispatchAsyncTask([]() {
+            ResourceCache::getInstance().evictIdle();
+        }, Execution::Priority::Background);
+    });
+}
+
+ResourceCache& ResourceCache::getInstance() {
+    static ResourceCache instance;
+    return instance;
+}
+
+void ResourceCache::initialize() {
+    const int budgetMb = Configuration::getInstance()
+        .getValue(QStringLiteral("resources.cache_budget_mb"), DefaultCacheBudgetMb)
+        .toInt();
+    setBudgetBytes(static_cast<qint64>(budgetMb) * BytesPerMegabyte);
+
+    const int graceSeconds = Configuration::getInstance()
+        .getValue(QStringLiteral("resources.idle_grace_s"), DefaultIdleGraceSeconds)
+        .toInt();
+    {
+        QMutexLocker locker(&m_mutex);
+        m_idleGraceMs = static_cast<qint64>(graceSeconds) * 1000;
+    }
+    if (graceSeconds > 0) {
+        m_idleSweepTimer.start(qMax(MinIdleSweepIntervalMs, graceSeconds * 1000 / IdleSweepsPerGracePeriod));
+    } else {
+        m_idleSweepTimer.stop();
+    }
+}
+
+QSharedPointer<Resource> ResourceCache::find(const QString& key) {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        ++m_misses;
+        return {};
+    }
+    ++m_hits;
+    it.value().used = true;
+    touchLocked(key, it.value());
+    return it.value().resource;
+}
+
+bool ResourceCache::contains(const QString& key) const {
+    QMutexLocker locker(&m_mutex);
+    if (m_entries.contains(key)) {
+        return true;
+    }
+    auto it = m_pendingLoads.constFind(key);
+    return it != m_pendingLoads.constEnd() && !it->token.isCancelled();
+}
+
+void ResourceCache::insert(const QString& key, const QSharedPointer<Resource>& resource, bool prefetch) {
+    QMutexLocker locker(&m_mutex);
+    insertLocked(key, resource, prefetch);
+}
+
+void ResourceCache::insertLocked(const QString& key, const QSharedPointer<Resource>& resource, bool prefetch) {
+    if (key.isEmpty() || resource.isNull()) {
+        return;
+    }
+    auto existing = m_entries.find(key);
+    if (existing != m_entries.end() && existing.value().resource == resource) {
+        // Re-published (e.g. a cache hit finishing its load); keep what find() recorded.
+        existing.value().prefetch = existing.value().prefetch && prefetch;
+        touchLocked(key, existing.value());
+        return;
+    }
+    removeLocked(key);
+
+    Entry entry;
+    entry.resource = resource;
+    entry.size = static_cast<qint64>(resource->getSize());
+    entry.prefetch = prefetch;
+    entry.sourceUrl = resource->getUrl();
+    // The same payload may be cached under several keys (e.g. decode-size
+    // variants); its bytes are only counted once.
+    if (++m_keyCounts[resource.data()] == 1) {
+        m_usedBytes += entry.size;
+    }
+    Entry& stored = m_entries.insert(key, entry).value();
+    touchLocked(key, stored);
+    evictLocked();
+}
+
+void ResourceCache::remove(const QString& key) {
+    QMutexLocker locker(&m_mutex);
+    removeLocked(key);
+}
+
+void ResourceCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_keyCounts.clear();
+    m_usedBytes = 0;
+}
+
+qint64 ResourceCache::releaseUnused() {
+    QMutexLocker locker(&m_mutex);
+    return releaseEvictableLocked([](const Entry& entry) {
+        return entry.prefetch && !entry.used;
+    });
+}
+
+qint64 ResourceCache::releaseTextures() {
+    QMutexLocker locker(&m_mutex);
+    return releaseEvictableLocked([](const Entry& entry) {
+        return dynamic_cast<const TextureResource*>(entry.resource.data()) != nullptr;
+    });
+}
+
+template <typename Predicate>
+qint64 ResourceCache::releaseEvictableLocked(Predicate shouldRelease) {
+    const qint64 usedBefore = m_usedBytes;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (!isEvictableLocked(it.value()) || !shouldRelease(it.value())) {
+            ++it;
+            continue;
+        }
+        m_lru.remove(it.value().useTick);
+        releaseLocked(it.value());
+        it = m_entries.erase(it);
+    }
+    return usedBefore - m_usedBytes;
+}
+
+void ResourceCache::retain(const QString& url) {
+    QMutexLocker locker(&m_mutex);
+    if (++m_holderCounts[url] == 1) {
+        m_releasedAtMs.remove(url);
+    }
+}
+
+void ResourceCache::release(const QString& url) {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_holderCounts.find(url);
+    if (it == m_holderCounts.end()) {
+        return;
+    }
+    if (--it.value() <= 0) {
+        m_holderCounts.erase(it);
+        m_releasedAtMs.insert(url, m_clock.elapsed());
+        // Its entries may have been kept over budget only because they were held.
+        evictLocked();
+    }
+}
+
+int ResourceCache::getHolderCount(const QString& url) const {
+    QMutexLocker locker(&m_mutex);
+    return m_holderCounts.value(url);
+}
+
+int ResourceCache::evictIdle() {
+    QMutexLocker locker(&m_mutex);
+    if (m_idleGraceMs <= 0) {
+        return 0;
+    }
+    const qint64 idleBeforeMs = m_clock.elapsed() - m_idleGraceMs;
+    int evictedCount = 0;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        const Entry& entry = it.value();
+        const qint64 lastUsedMs = qMax(entry.lastUsedMs, m_releasedAtMs.value(entry.sourceUrl));
+        if (lastUsedMs > idleBeforeMs || !isEvictableLocked(entry)) {
+            ++it;
+            continue;
+        }
+        m_lru.remove(entry.useTick);
+        releaseLocked(entry);
+        it = m_entries.erase(it);
+        ++evictedCount;
+    }
+    // Release times only matter while they can still postpone an eviction.
+    for (auto it = m_releasedAtMs.begin(); it != m_releasedAtMs.end();) {
+        it = it.value() <= idleBeforeMs ? m_releasedAtMs.erase(it) : std::next(it);
+    }
+    m_idleEvictions += evictedCount;
+    if (evictedCount > 0) {
+        qDebug() << "ResourceCache evicted" << evictedCount << "idle entries";
+    }
+    return evictedCount;
+}
+
+bool ResourceCache::attachPendingLoad(const QString& key, QFuture<QSharedPointer<Resource>>& future,
+                                      CancellationToken& token, bool prefetch) {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_pendingLoads.find(key);
+    if (it != m_pendingLoads.end()) {
+        // A cancelled load may have been dropped from the queue without ever
+        // finishing its entry here; joining it would wait on a dead future.
+        const CancellationToken joined = it->token.join();
+        if (joined.isValid() || !it->token.isValid()) {
+            future = it->future;
+            token = joined;
+            it->prefetch = it->prefetch && prefetch;
+            ++m_coalescedLoads;
+            return true;
+        }
+    }
+    PendingLoad pending;
+    pending.future = future;
+    pending.token = token;
+    pending.prefetch = prefetch;
+    m_pendingLoads.insert(key, pending);
+    return false;
+}
+
+void ResourceCache::finishPendingLoad(const QString& key, const CancellationToken& token) {
+    QMutexLocker locker(&m_mutex);
+    finishPendingLoadLocked(key, token);
+}
+
+void ResourceCache::publishPendingLoad(const QString& key, const CancellationToken& token,
+                                       const QSharedPointer<Resource>& resource) {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_pendingLoads.constFind(key);
+    const bool prefetch = it != m_pendingLoads.constEnd() && it->token.isSameWork(token) && it->prefetch;
+    insertLocked(key, resource, prefetch);
+    finishPendingLoadLocked(key, token);
+}
+
+void ResourceCache::finishPendingLoadLocked(const QString& key, const CancellationToken& token) {
+    // A cancelled load can be superseded by a fresh one under the same key.
+    auto it = m_pendingLoads.find(key);
+    if (it != m_pendingLoads.end() && it->token.isSameWork(token)) {
+        m_pendingLoads.erase(it);
+    }
+}
+
+void ResourceCache::recordCancelledLoad() {
+    QMutexLocker locker(&m_mutex);
+    ++m_cancelledLoads;
+}
+
+void ResourceCache::setPendingTaskId(const QString& key, quint64 taskId) {
+    QMutexLocker locker(&m_mutex);
+    // The load may already have finished on a worker before its id was known.
+    auto it = m_pendingLoads.find(key);
+    if (it != m_pendingLoads.end()) {
+        it->taskId = taskId;
+    }
+}
+
+quint64 ResourceCache::getPendingTaskId(const QString& key) const {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_pendingLoads.constFind(key);
+    return it != m_pendingLoads.constEnd() ? it->taskId : 0;
+}
+
+qint64 ResourceCache::getBudgetBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_budgetBytes;
+}
+
+void ResourceCache::setBudgetBytes(qint64 budgetBytes) {
+    QMutexLocker locker(&m_mutex);
+    m_budgetBytes = qMax<qint64>(0, budgetBytes);
+    evictLocked();
+}
+
+ResourceCache::Stats ResourceCache::getStats() const {
+    QMutexLocker locker(&m_mutex);
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.usedBytes = m_usedBytes;
+    stats.budgetBytes = m_budgetBytes;
+    stats.entryCount = static_cast<int>(m_entries.size());
+    stats.coalescedLoads = m_coalescedLoads;
+    stats.cancelledLoads = m_cancelledLoads;
+    stats.idleEvictions = m_idleEvictions;
+    stats.heldResources = static_cast<int>(m_holderCounts.size());
+    return stats;
+}
+
+void ResourceCache::touchLocked(const QString& key, Entry& entry) {
+    if (entry.useTick != 0) {
+        m_lru.remove(entry.useTick);
+    }
+    entry.useTick = ++m_nextTick;
+    entry.lastUsedMs = m_clock.elapsed();
+    m_lru.insert(entry.useTick, key);
+}
+
+void ResourceCache::removeLocked(const QString& key) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return;
+    }
+    m_lru.remove(it.value().useTick);
+    releaseLocked(it.value());
+    m_entries.erase(it);
+}
+
+void ResourceCache::releaseLocked(const Entry& entry) {
+    auto it = m_keyCounts.find(entry.resource.data());
+    if (it == m_keyCounts.end()) {
+        return;
+    }
+    if (--it.value() <= 0) {
+        m_keyCounts.erase(it);
+        m_usedBytes -= entry.size;
+    }
+}
+
+bool ResourceCache::isEvictableLocked(const Entry& entry) const {
+    return !m_holderCounts.contains(entry.sourceUrl);
+}
+
+void ResourceCache::evictLocked() {
+    auto it = m_lru.begin();
+    while (m_usedBytes > m_budgetBytes && it != m_lru.end()) {
+        auto entryIt = m_entries.find(it.value());
+        if (entryIt != m_entries.end() && !isEvictableLocked(entryIt.value())) {
+            ++it;
+            continue;
+        }
+        it = m_lru.erase(it);
+        if (entryIt != m_entries.end()) {
+            releaseLocked(entryIt.value());
+            m_entries.erase(entryIt);
+        }
+        ++m_evictions;
+    }
+}
@@ -0,0 +1,64 @@
+#include "resources/ResourceHandle.h"
+
+#include "resources/ResourceCache.h"
+#include "resources/Resources.h"
+
+#include <utility>
+
+ResourceHandle::ResourceHandle(const QString& source) {
+    if (source.isEmpty()) {
+        return;
+    }
+    // Names map to URLs; anything unregistered is taken to be a URL already.
+    const QVariant registered = Resources::getInstance().getResource(source);
+    m_url = registered.typeId() == QMetaType::QString ? registered.toString() : source;
+    ResourceCache::getInstance().retain(m_url);
+}
+
+ResourceHandle::ResourceHandle(const ResourceHandle& other)
+    : m_url(other.m_url)
+{
+    if (!m_url.isEmpty()) {
+        ResourceCache::getInstance().retain(m_url);
+    }
+}
+
+ResourceHandle& ResourceHandle::operator=(const ResourceHandle& other) {
+    if (this != &other && m_url != other.m_url) {
+        ResourceHandle copy(other);
+        std::swap(m_url, copy.m_url);
+    }
+    return *this;
+}
+
+ResourceHandle::ResourceHandle(ResourceHandle&& other) noexcept
+    : m_url(std::exchange(other.m_url, QString()))
+{
+}
+
+ResourceHandle& ResourceHandle::operator=(ResourceHandle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        m_url = std::exchange(other.m_url, QString());
+    }
+    return *this;
+}
+
+ResourceHandle::~ResourceHandle() {
+    reset();
+}
+
+bool ResourceHandle::isValid() const {
+    return !m_url.isEmpty();
+}
+
+const QString& ResourceHandle::getUrl() const {
+    return m_url;
+}
+
+void ResourceHandle::reset() {
+    if (!m_url.isEmpty()) {
+        ResourceCache::getInstance().release(m_url);
+        m_url.clear();
+    }
+}
@@ -0,0 +1,53 @@
+#include "resources/ResourceImageProvider.h"
+
+#include "resources/Loader.h"
+#include "resources/Resources.h"
+#include "resources/TextureResource.h"
+
+#include <QDebug>
+
+#include <limits>
+
+ResourceImageProvider::ResourceImageProvider()
+    : QQuickImageProvider(QQuickImageProvider::Image)
+{
+}
+
+QImage ResourceImageProvider::requestImage(const QString& id, QSize* size, const QSize& requestedSize) {
+    const QSharedPointer<Loader> loader = Resources::getInstance().getLoader(id);
+    if (loader.isNull()) {
+        qWarning() << "ResourceImageProvider has no loader for:" << id;
+        return {};
+    }
+    QSharedPointer<Resource> resource;
+    const auto* bitmapLoader = qobject_cast<BitmapLoader*>(loader.data());
+    if (bitmapLoader != nullptr && (requestedSize.width() > 0 || requestedSize.height() > 0)) {
+        // The shared loader's target size is used by every other requester, so
+        // a sourceSize gets its own loader; the decoded variant is still
+        // cached and coalesced under the shared url@WxH key.
+        QSize bounds = requestedSize;
+        if (bounds.width() <= 0) {
+            bounds.setWidth(std::numeric_limits<int>::max());
+        }
+        if (bounds.height() <= 0) {
+            bounds.setHeight(std::numeric_limits<int>::max());
+        }
+        BitmapLoader sizedLoader;
+        sizedLoader.setSourceUrl(bitmapLoader->getSourceUrl());
+        sizedLoader.setTargetSize(bounds);
+        resource = sizedLoader.loadSync();
+    } else {
+        // A cache lookup when the texture is already resident.
+        resource = loader->loadSync();
+    }
+    const QSharedPointer<TextureResource> texture = resource.dynamicCast<TextureResource>();
+    if (texture.isNull()) {
+        qWarning() << "ResourceImageProvider resource is not a texture:" << id;
+        return {};
+    }
+    const QImage image = texture->getImage();
+    if (size != nullptr) {
+        *size = image.size();
+    }
+    return image;
+}
@@ -0,0 +1,120 @@
+#include "resources/ResourceWatcher.h"
+
+#include "core/Configuration.h"
+#include "resources/Loader.h"
+#include "resources/Resources.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QUrl>
+
+#include <utility>
+
+namespace {
+constexpr int DefaultDebounceMs = 200;
+
+QString localFilePath(const QString& url) {
+    if (url.startsWith(QStringLiteral("file://"))) {
+        return QUrl(url).toLocalFile();
+    }
+    return url;
+}
+}
+
+ResourceWatcher::ResourceWatcher()
+    : QObject(nullptr)
+    , m_watcher(nullptr)
+    , m_reloadCount(0)
+{
+    m_debounceTimer.setSingleShot(true);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &ResourceWatcher::flushChanges);
+}
+
+ResourceWatcher& ResourceWatcher::getInstance() {
+    static ResourceWatcher instance;
+    return instance;
+}
+
+void ResourceWatcher::initialize() {
+    const Configuration& config = Configuration::getInstance();
+    if (!config.getValue(QStringLiteral("resources.hot_reload"), false).toBool() || m_watcher != nullptr) {
+        return;
+    }
+    m_debounceTimer.setInterval(config
+        .getValue(QStringLiteral("resources.hot_reload_debounce_ms"), DefaultDebounceMs)
+        .toInt());
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &ResourceWatcher::handleFileChanged);
+
+    const QStringList names = Resources::getInstance().getResourceNamesByProtocol(QStringLiteral("file"));
+    for (const QString& name : names) {
+        watchResource(name);
+    }
+    qDebug() << "Hot reload watching" << getWatchedFileCount() << "files";
+}
+
+bool ResourceWatcher::isEnabled() const {
+    return m_watcher != nullptr;
+}
+
+bool ResourceWatcher::watchResource(const QString& name) {
+    if (m_watcher == nullptr) {
+        return false;
+    }
+    const QVariant value = Resources::getInstance().getResource(name);
+    if (value.typeId() != QMetaType::QString) {
+        return false;
+    }
+    const QFileInfo fileInfo(localFilePath(value.toString()));
+    if (!fileInfo.isFile()) {
+        return false;
+    }
+    const QString filePath = fileInfo.absoluteFilePath();
+    QStringList& names = m_namesByPath[filePath];
+    if (!names.contains(name)) {
+        names.append(name);
+    }
+    if (names.size() == 1 && !m_watcher->addPath(filePath)) {
+        qWarning() << "Hot reload cannot watch:" << filePath;
+    }
+    return true;
+}
+
+int ResourceWatcher::getWatchedFileCount() const {
+    return m_watcher != nullptr ? static_cast<int>(m_watcher->files().size()) : 0;
+}
+
+quint64 ResourceWatcher::getReloadCount() const {
+    return m_reloadCount;
+}
+
+void ResourceWatcher::handleFileChanged(const QString& filePath) {
+    m_changedPaths.insert(filePath);
+    m_debounceTimer.start();
+}
+
+void ResourceWatcher::flushChanges() {
+    const QSet<QString> changedPaths = std::exchange(m_changedPaths, {});
+    const Resources& resources = Resources::getInstance();
+    for (const QString& filePath : changedPaths) {
+        if (!QFileInfo::exists(filePath)) {
+            // Deleted (or mid-rename); keep serving what is loaded.
+            continue;
+        }
+        // Saving by writing a new file and renaming it over the old one drops
+        // the path from the watcher.
+        if (!m_watcher->files().contains(filePath)) {
+            m_watcher->addPath(filePath);
+        }
+        const QStringList names = m_namesByPath.value(filePath);
+        for (const QString& name : names) {
+            const QSharedPointer<Loader> loader = resources.findLoader(name);
+            if (!loader.isNull() && loader->reload().isValid()) {
+                ++m_reloadCount;
+                qDebug() << "Hot reloading resource:" << name;
+            }
+        }
+        emit fileChanged(filePath);
+    }
+}
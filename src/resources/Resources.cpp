@@ -1,17 +1,32 @@
 #include "resources/Resources.h"
 
+#include "core/Configuration.h"
 #include "factory/Registration.h"
+#include "resources/AssetPack.h"
+#include "resources/LoadGroup.h"
 #include "resources/Loader.h"
+#include "resources/ResourceManifestFormat.h"
 
+#include <QCoreApplication>
 #include <QDir>
 #include <QDirIterator>
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
+#include <QMutexLocker>
+
+namespace {
+QString packUrlPrefix() {
+    return QString::fromLatin1(AssetPack::Protocol) + QStringLiteral("://");
+}
+}
 
 Resources::Resources() {
+    loadManifest();
     registerDefaultLoaders();
+    registerAssetPacks();
     registerResourcesFromQrc();
+    registerDevAssets();
 }
 
 Resources& Resources::getInstance() {
@@ -31,34 +46,140 @@ void Resources::addResource(const QString& name, const QVariant& value) {
             return;
         }
     }
+    const auto previous = m_resources.constFind(name);
+    if (previous != m_resources.constEnd() && previous.value().canConvert<QString>()) {
+        unindexResource(name, previous.value().toString());
+    }
     m_resources[name] = value;
-    resolveLoaderForResource(name, value);
+    if (value.canConvert<QString>()) {
+        indexResource(name, value.toString());
+    }
+    registerLoaderDescriptor(name, value);
 }
 
 QSharedPointer<Loader> Resources::getLoader(const QString& name) const {
+    QMutexLocker locker(&m_loaderMutex);
+    const auto live = m_resourceLoaders.constFind(name);
+    if (live != m_resourceLoaders.constEnd()) {
+        return live.value();
+    }
+    const auto descriptor = m_loaderDescriptors.constFind(name);
+    if (descriptor == m_loaderDescriptors.constEnd()) {
+        return {};
+    }
+    const QSharedPointer<Loader> loader = createLoader(name, descriptor.value());
+    if (loader.isNull()) {
+        // Forget it so a broken entry warns once instead of on every lookup.
+        m_loaderDescriptors.erase(descriptor);
+        return {};
+    }
+    m_resourceLoaders.insert(name, loader);
+    return loader;
+}
+
+bool Resources::hasLoader(const QString& name) const {
+    QMutexLocker locker(&m_loaderMutex);
+    return m_loaderDescriptors.contains(name);
+}
+
+QSharedPointer<Loader> Resources::findLoader(const QString& name) const {
+    QMutexLocker locker(&m_loaderMutex);
     return m_resourceLoaders.value(name);
 }
 
+int Resources::getRegisteredLoaderCount() const {
+    QMutexLocker locker(&m_loaderMutex);
+    return static_cast<int>(m_loaderDescriptors.size());
+}
+
+int Resources::getLiveLoaderCount() const {
+    QMutexLocker locker(&m_loaderMutex);
+    return static_cast<int>(m_resourceLoaders.size());
+}
+
 QVariant Resources::getResource(const QString& name) const {
     return m_resources.value(name);
 }
 
 QStringList Resources::getResourceUrlsBySuffix(const QString& suffix) const {
     QStringList urls;
-    const QString suffixLower = suffix.toLower();
-    for (auto it = m_resources.constBegin(); it != m_resources.constEnd(); ++it) {
-        if (!it.value().canConvert<QString>()) {
-            continue;
+    const auto index = m_suffixIndex.constFind(suffix.toLower());
+    if (index == m_suffixIndex.constEnd()) {
+        return urls;
+    }
+    urls.reserve(index->size());
+    for (const QString& name : *index) {
+        urls.append(m_resources.value(name).toString());
+    }
+    return urls;
+}
+
+QStringList Resources::getResourceNamesByProtocol(const QString& protocol) const {
+    const auto index = m_protocolIndex.constFind(protocol);
+    if (index == m_protocolIndex.constEnd()) {
+        return {};
+    }
+    return QStringList(index->cbegin(), index->cend());
+}
+
+QStringList Resources::findResourceNames(const QString& pathPrefix, const QStringList& suffixes) const {
+    QStringList names;
+    if (suffixes.isEmpty()) {
+        appendRange(m_pathIndex, pathPrefix, names);
+        return names;
+    }
+    for (const QString& suffix : suffixes) {
+        const auto index = m_suffixIndex.constFind(suffix.toLower());
+        if (index != m_suffixIndex.constEnd()) {
+            appendRange(*index, pathPrefix, names);
+        }
+    }
+    return names;
+}
+
+void Resources::appendRange(const QMultiMap<QString, QString>& index, const QString& pathPrefix, QStringList& names) {
+    for (auto it = index.lowerBound(pathPrefix); it != index.cend() && it.key().startsWith(pathPrefix); ++it) {
+        names.append(it.value());
+    }
+}
+
+void Resources::indexResource(const QString& name, const QString& url) {
+    const QString path = extractPath(url);
+    m_pathIndex.insert(path, name);
+    m_suffixIndex[extractSuffix(url)].insert(path, name);
+    m_protocolIndex[extractProtocol(url)].insert(name);
+}
+
+void Resources::unindexResource(const QString& name, const QString& url) {
+    const QString path = extractPath(url);
+    m_pathIndex.remove(path, name);
+    // Empty buckets are dropped so the indexes only hold suffixes and protocols in use.
+    const auto suffixIndex = m_suffixIndex.find(extractSuffix(url));
+    if (suffixIndex != m_suffixIndex.end()) {
+        suffixIndex->remove(path, name);
+        if (suffixIndex->isEmpty()) {
+            m_suffixIndex.erase(suffixIndex);
         }
-        const QString url = it.value().toString();
-        if (extractSuffix(url) == suffixLower) {
-            urls.append(url);
+    }
+    const auto protocolIndex = m_protocolIndex.find(extractProtocol(url));
+    if (protocolIndex != m_protocolIndex.end()) {
+        protocolIndex->remove(name);
+        if (protocolIndex->isEmpty()) {
+            m_protocolIndex.erase(protocolIndex);
         }
     }
-    return urls;
 }
 
 void Resources::registerResourcesFromQrc() {
+    if (!m_manifest.isEmpty()) {
+        const QString qrcPrefix = QStringLiteral("qrc:/");
+        for (auto it = m_manifest.constBegin(); it != m_manifest.constEnd(); ++it) {
+            if (it.key().startsWith(qrcPrefix)) {
+                addResource(it.key(), it.key());
+            }
+        }
+        return;
+    }
     QDirIterator it(":/", QDir::Files, QDirIterator::Subdirectories);
     while (it.hasNext()) {
         const QString qrcPath = it.next();
@@ -67,13 +188,148 @@ void Resources::registerResourcesFromQrc() {
     }
 }
 
-void Resources::resolveLoaderForResource(const QString& name, const QVariant& value) {
+void Resources::registerDevAssets() {
+    const QString devAssetDir = Configuration::getInstance()
+        .getValue(QStringLiteral("resources.dev_asset_dir"))
+        .toString();
+    if (devAssetDir.isEmpty()) {
+        return;
+    }
+    const QDir root(devAssetDir);
+    if (!root.exists()) {
+        qWarning() << "Dev asset directory does not exist:" << devAssetDir;
+        return;
+    }
+    int overriddenCount = 0;
+    int addedCount = 0;
+    QDirIterator it(root.absolutePath(), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString filePath = it.next();
+        // A loose copy of an embedded asset takes over its name, so everything
+        // that refers to the qrc URL now loads (and hot reloads) the file.
+        const QString qrcUrl = QStringLiteral("qrc:/") + root.relativeFilePath(filePath);
+        if (m_resources.contains(qrcUrl)) {
+            addResource(qrcUrl, filePath);
+            ++overriddenCount;
+        } else {
+            addResource(filePath, filePath);
+            ++addedCount;
+        }
+    }
+    qDebug() << "Dev assets from" << root.absolutePath() << "-" << overriddenCount << "override qrc,"
+             << addedCount << "added";
+}
+
+bool Resources::loadManifest() {
+    QFile file(QString::fromLatin1(ResourceManifestFormat::ResourcePath));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray text = file.readAll();
+    const QList<QByteArray> lines = text.split('\n');
+    const QByteArray expectedHeader = QByteArray(ResourceManifestFormat::Magic) + ' '
+        + QByteArray::number(ResourceManifestFormat::Version);
+    if (lines.isEmpty() || lines.first() != expectedHeader) {
+        qWarning() << "Ignoring resource manifest with unknown header:" << lines.value(0);
+        return false;
+    }
+
+    qint64 totalBytes = 0;
+    m_manifest.reserve(lines.size() - 1);
+    for (qsizetype i = 1; i < lines.size(); ++i) {
+        const QList<QByteArray> fields = lines[i].split(ResourceManifestFormat::FieldSeparator);
+        if (fields.size() != ResourceManifestFormat::FieldCount) {
+            continue;
+        }
+        ManifestEntry entry;
+        entry.size = fields[2].toLongLong();
+        entry.contentHash = fields[3].toULongLong(nullptr, 16);
+        totalBytes += entry.size;
+        m_manifest.insert(QString::fromUtf8(fields[0]), entry);
+    }
+    qDebug() << "Resource manifest:" << m_manifest.size() << "entries," << totalBytes << "source bytes";
+    return !m_manifest.isEmpty();
+}
+
+void Resources::registerAssetPacks() {
+    const QStringList packPaths = Configuration::getInstance()
+        .getValue(QStringLiteral("resources.asset_packs"))
+        .toString()
+        .split(',', Qt::SkipEmptyParts);
+    const QString prefix = packUrlPrefix();
+    for (const QString& packPath : packPaths) {
+        auto pack = QSharedPointer<AssetPack>::create(packPath.trimmed());
+        if (!pack->open()) {
+            continue;
+        }
+        m_assetPacks.append(pack);
+        const QStringList paths = pack->getPaths();
+        for (const QString& path : paths) {
+            const QString url = prefix + path;
+            addResource(url, url);
+        }
+    }
+}
+
+QByteArray Resources::readPackedResource(const QString& url) const {
+    QStringView packPath;
+    const AssetPack* pack = findAssetPack(url, packPath);
+    if (pack == nullptr) {
+        return {};
+    }
+    return pack->read(packPath);
+}
+
+qint64 Resources::getSourceSize(const QString& name) const {
+    const QVariant value = m_resources.value(name);
     if (!value.canConvert<QString>()) {
-        m_resourceLoaders.remove(name);
+        return 0;
+    }
+    const QString url = value.toString();
+    const auto manifestEntry = m_manifest.constFind(url);
+    if (manifestEntry != m_manifest.constEnd()) {
+        return manifestEntry->size;
+    }
+    if (url.startsWith(packUrlPrefix())) {
+        return readPackedResource(url).size();
+    }
+    if (url.startsWith("qrc:/")) {
+        return QFileInfo(":" + url.mid(4)).size();
+    }
+    return QFileInfo(url).size();
+}
+
+QSharedPointer<LoadGroup> Resources::createLoadGroup(const QStringList& names, Execution::Priority priority) const {
+    // Completions may drop the last reference on a worker thread.
+    return QSharedPointer<LoadGroup>(new LoadGroup(names, priority), &QObject::deleteLater);
+}
+
+const AssetPack* Resources::findAssetPack(const QString& url, QStringView& packPath) const {
+    const QString prefix = packUrlPrefix();
+    if (!url.startsWith(prefix)) {
+        return nullptr;
+    }
+    packPath = QStringView(url).mid(prefix.size());
+    // Later packs override earlier ones, so patches can ship as an extra pack.
+    for (auto it = m_assetPacks.crbegin(); it != m_assetPacks.crend(); ++it) {
+        if ((*it)->contains(packPath)) {
+            return it->data();
+        }
+    }
+    return nullptr;
+}
+
+void Resources::registerLoaderDescriptor(const QString& name, const QVariant& value) {
+    QMutexLocker locker(&m_loaderMutex);
+    m_resourceLoaders.remove(name);
+    if (!value.canConvert<QString>()) {
+        m_loaderDescriptors.remove(name);
         return;
     }
+    m_loaderDescriptors.insert(name, value.toString());
+}
 
-    const QString source = value.toString();
+QSharedPointer<Loader> Resources::createLoader(const QString& name, const QString& source) const {
     const QString protocol = extractProtocol(source);
     const QString suffix = extractSuffix(source);
 
@@ -85,17 +341,21 @@ void Resources::resolveLoaderForResource(const QString& name, const QVariant& va
     QSharedPointer<QObject> object = Registration::getInstance().create("Native", properties);
     if (object.isNull()) {
         qWarning() << "Unable to create object for resource loader:" << name << source;
-        m_resourceLoaders.remove(name);
-        return;
+        return {};
     }
     QSharedPointer<Loader> loader = object.dynamicCast<Loader>();
     if (loader.isNull()) {
         qWarning() << "Resolved object is not Loader for resource:" << name << source;
-        m_resourceLoaders.remove(name);
-        return;
+        return {};
     }
     loader->setSourceUrl(source);
-    m_resourceLoaders[name] = loader;
+    // getLoader() may run on a worker or the render thread; loaders deliver
+    // their results through the GUI thread's event loop.
+    QCoreApplication* application = QCoreApplication::instance();
+    if (application != nullptr && loader->thread() != application->thread()) {
+        loader->moveToThread(application->thread());
+    }
+    return loader;
 }
 
 QString Resources::normalizeResourcePath(const QString& value) {
@@ -108,9 +368,14 @@ QString Resources::normalizeResourcePath(const QString& value) {
     return value;
 }
 
-bool Resources::resourceExists(const QString& value) {
+bool Resources::resourceExists(const QString& value) const {
+    if (value.startsWith(packUrlPrefix())) {
+        QStringView packPath;
+        return findAssetPack(value, packPath) != nullptr;
+    }
     if (value.startsWith("qrc:/")) {
-        return QFile::exists(":" + value.mid(4));
+        // Everything in the manifest was compiled into the binary.
+        return m_manifest.contains(value) || QFile::exists(":" + value.mid(4));
     }
     if (value.startsWith(":/")) {
         return QFile::exists(value);
@@ -129,6 +394,20 @@ QString Resources::extractProtocol(const QString& value) {
     return "file";
 }
 
+QString Resources::extractPath(const QString& value) {
+    if (value.startsWith("qrc:/")) {
+        return value.mid(5);
+    }
+    if (value.startsWith(":/")) {
+        return value.mid(2);
+    }
+    const int separatorIndex = value.indexOf("://");
+    if (separatorIndex >= 0) {
+        return value.mid(separatorIndex + 3);
+    }
+    return value;
+}
+
 QString Resources::extractSuffix(const QString& value) {
     const int dotIndex = value.lastIndexOf('.');
     if (dotIndex < 0 || dotIndex + 1 >= value.size()) {
@@ -0,0 +1,35 @@
+#include "resources/SoundBankResource.h"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+SoundBankResource::SoundBankResource(const QString& url)
+    : Resource(url)
+    , m_pcmBytes(0)
+{
+}
+
+size_t SoundBankResource::getSize() const {
+    QReadLocker lock(&m_lock);
+    return m_pcmBytes;
+}
+
+QByteArray SoundBankResource::getClip(const QString& name) const {
+    QReadLocker lock(&m_lock);
+    return m_clips.value(name);
+}
+
+QStringList SoundBankResource::getClipNames() const {
+    QReadLocker lock(&m_lock);
+    return m_clips.keys();
+}
+
+void SoundBankResource::addClip(const QString& name, const QByteArray& pcm) {
+    QWriteLocker lock(&m_lock);
+    const auto previous = m_clips.constFind(name);
+    if (previous != m_clips.constEnd()) {
+        m_pcmBytes -= static_cast<size_t>(previous.value().size());
+    }
+    m_clips.insert(name, pcm);
+    m_pcmBytes += static_cast<size_t>(pcm.size());
+}
@@ -0,0 +1,216 @@
+#include "resources/SoundEffects.h"
+
+#include "core/CancellationToken.h"
+#include "core/Configuration.h"
+#include "core/Execution.h"
+#include "resources/Loader.h"
+#include "resources/Resources.h"
+#include "resources/SoundBankResource.h"
+#include "resources/SoundMixerDevice.h"
+
+#include <QAudioDevice>
+#include <QAudioSink>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QMediaDevices>
+#include <QMutexLocker>
+#include <QThread>
+
+namespace {
+constexpr int DefaultMaxVoices = 16;
+// Past the sink buffer draining, before an idle output is suspended.
+constexpr int IdleSuspendMarginMs = 50;
+constexpr int FallbackSampleRate = 48000;
+constexpr int MaxOutputChannels = 2;
+}
+
+SoundEffects::SoundEffects()
+    : QObject(nullptr)
+    , m_sink(nullptr)
+    , m_mixer(nullptr)
+    , m_outputActive(false)
+    , m_outputAvailable(false)
+    , m_outputResumes(0)
+{
+    m_idleTimer.setSingleShot(true);
+    connect(&m_idleTimer, &QTimer::timeout, this, &SoundEffects::suspendIdleOutput);
+}
+
+SoundEffects& SoundEffects::getInstance() {
+    static SoundEffects instance;
+    return instance;
+}
+
+void SoundEffects::initialize() {
+    if (m_mixer != nullptr) {
+        return;
+    }
+    const Configuration& config = Configuration::getInstance();
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+
+    QAudioFormat format = device.isNull() ? QAudioFormat() : device.preferredFormat();
+    if (!format.isValid()) {
+        format.setSampleRate(FallbackSampleRate);
+        format.setChannelCount(MaxOutputChannels);
+    }
+    // Mixing is done in 16-bit integers; clips are decoded straight to this.
+    format.setSampleFormat(QAudioFormat::Int16);
+    format.setChannelCount(qMin(format.channelCount(), MaxOutputChannels));
+    m_format = format;
+
+    m_mixer = new SoundMixerDevice(config.getValue(QStringLiteral("audio.max_voices"), DefaultMaxVoices).toInt(), this);
+    m_mixer->setFrameBytes(m_format.bytesPerFrame());
+    m_mixer->setIdleCallback([this]() {
+        QMetaObject::invokeMethod(this, &SoundEffects::scheduleIdleSuspend, Qt::QueuedConnection);
+    });
+    m_mixer->open(QIODevice::ReadOnly);
+
+    if (!device.isNull() && device.isFormatSupported(m_format)) {
+        // Started by the first play(), not here: an idle sink would pull silence forever.
+        m_sink = new QAudioSink(device, m_format, this);
+        m_outputAvailable = true;
+        qDebug() << "SoundEffects output:" << device.description() << m_format.sampleRate() << "Hz"
+                 << m_format.channelCount() << "ch";
+    } else {
+        qWarning() << "No usable audio output, sound effects are disabled";
+    }
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+            this, &SoundEffects::stopOutput, Qt::UniqueConnection);
+}
+
+QAudioFormat SoundEffects::getFormat() const {
+    return m_format;
+}
+
+void SoundEffects::loadBank(const QString& bankName) {
+    {
+        QMutexLocker locker(&m_banksMutex);
+        if (m_banks.contains(bankName)) {
+            return;
+        }
+    }
+    const QSharedPointer<Loader> loader = Resources::getInstance().getLoader(bankName);
+    if (loader.isNull()) {
+        qWarning() << "Unknown sound bank:" << bankName;
+        return;
+    }
+    CancellationToken token;
+    loader->requestLoad({}, Execution::Priority::Visible, token)
+        .then(QtFuture::Launch::Sync, [this, bankName](const QSharedPointer<Resource>& resource) {
+            Execution::getInstance().dispatchMainThreadTask([this, bankName, resource]() {
+                const QSharedPointer<SoundBankResource> bank = resource.dynamicCast<SoundBankResource>();
+                if (bank.isNull()) {
+                    qWarning() << "Failed to load sound bank:" << bankName;
+                    return;
+                }
+                QMutexLocker locker(&m_banksMutex);
+                m_banks.insert(bankName, bank);
+                qDebug() << "Sound bank" << bankName << "resident:" << bank->getClipNames().size()
+                         << "clips," << bank->getSize() << "bytes PCM";
+            });
+        });
+}
+
+void SoundEffects::unloadBank(const QString& bankName) {
+    QMutexLocker locker(&m_banksMutex);
+    m_banks.remove(bankName);
+}
+
+bool SoundEffects::play(const QString& bankName, const QString& clipName, float volume) {
+    if (!m_outputAvailable) {
+        return false;
+    }
+    QByteArray pcm;
+    {
+        QMutexLocker locker(&m_banksMutex);
+        const QSharedPointer<SoundBankResource> bank = m_banks.value(bankName);
+        if (!bank.isNull()) {
+            pcm = bank->getClip(clipName);
+        }
+    }
+    if (pcm.isEmpty()) {
+        qWarning() << "Sound effect not loaded:" << bankName << clipName;
+        return false;
+    }
+    const Configuration& config = Configuration::getInstance();
+    if (!m_mixer->addVoice(pcm, volume * config.getMasterVolume() * config.getSoundEffectVolume())) {
+        return false;
+    }
+    if (!m_outputActive.exchange(true)) {
+        if (QThread::currentThread() == thread()) {
+            resumeOutput();
+        } else {
+            QMetaObject::invokeMethod(this, &SoundEffects::resumeOutput, Qt::QueuedConnection);
+        }
+    }
+    return true;
+}
+
+qint64 SoundEffects::getBankBytes(const QString& bankName) const {
+    QMutexLocker locker(&m_banksMutex);
+    const QSharedPointer<SoundBankResource> bank = m_banks.value(bankName);
+    return bank.isNull() ? 0 : static_cast<qint64>(bank->getSize());
+}
+
+SoundEffects::Stats SoundEffects::getStats() const {
+    Stats stats;
+    if (m_mixer != nullptr) {
+        const SoundMixerDevice::Stats mixerStats = m_mixer->getStats();
+        stats.triggers = mixerStats.triggers;
+        stats.dropped = mixerStats.dropped;
+        stats.averageLatencyUs = mixerStats.averageLatencyUs;
+        stats.maxLatencyUs = mixerStats.maxLatencyUs;
+    }
+    if (m_sink != nullptr) {
+        stats.sinkBufferUs = m_format.durationForBytes(m_sink->bufferSize());
+    }
+    stats.outputResumes = m_outputResumes;
+    return stats;
+}
+
+void SoundEffects::resumeOutput() {
+    m_idleTimer.stop();
+    m_outputActive = true;
+    if (m_sink == nullptr) {
+        return;
+    }
+    if (m_sink->state() == QAudio::SuspendedState) {
+        m_sink->resume();
+        ++m_outputResumes;
+    } else if (m_sink->state() == QAudio::StoppedState) {
+        m_sink->start(m_mixer);
+        ++m_outputResumes;
+    }
+}
+
+void SoundEffects::scheduleIdleSuspend() {
+    if (m_sink == nullptr || !m_outputActive) {
+        return;
+    }
+    // Let the last clip play out of the sink buffer first.
+    const qint64 bufferMs = m_format.durationForBytes(m_sink->bufferSize()) / 1000;
+    m_idleTimer.start(static_cast<int>(bufferMs) + IdleSuspendMarginMs);
+}
+
+void SoundEffects::suspendIdleOutput() {
+    // Cleared before the voice check: a play() racing with this sees the
+    // output inactive and queues resumeOutput(), which runs after the suspend.
+    m_outputActive = false;
+    if (m_mixer->getVoiceCount() > 0) {
+        resumeOutput();
+        return;
+    }
+    if (m_sink != nullptr && m_sink->state() == QAudio::ActiveState) {
+        m_sink->suspend();
+    }
+}
+
+void SoundEffects::stopOutput() {
+    m_outputAvailable = false;
+    m_idleTimer.stop();
+    if (m_sink != nullptr) {
+        m_sink->stop();
+        delete m_sink;
+        m_sink = nullptr;
+    }
+}
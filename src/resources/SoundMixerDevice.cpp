@@ -0,0 +1,118 @@
+#include "resources/SoundMixerDevice.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+SoundMixerDevice::SoundMixerDevice(int maxVoices, QObject* parent)
+    : QIODevice(parent)
+    , m_maxVoices(maxVoices)
+    , m_frameBytes(static_cast<qint64>(sizeof(qint16)))
+    , m_triggers(0)
+    , m_dropped(0)
+    , m_latencySamples(0)
+    , m_totalLatencyNs(0)
+    , m_maxLatencyNs(0)
+{
+    m_clock.start();
+}
+
+void SoundMixerDevice::setFrameBytes(qint64 frameBytes) {
+    QMutexLocker locker(&m_mutex);
+    m_frameBytes = qMax<qint64>(static_cast<qint64>(sizeof(qint16)), frameBytes);
+}
+
+void SoundMixerDevice::setIdleCallback(std::function<void()> onIdle) {
+    QMutexLocker locker(&m_mutex);
+    m_onIdle = std::move(onIdle);
+}
+
+bool SoundMixerDevice::addVoice(const QByteArray& pcm, float volume) {
+    QMutexLocker locker(&m_mutex);
+    ++m_triggers;
+    if (m_voices.size() >= m_maxVoices) {
+        ++m_dropped;
+        return false;
+    }
+    Voice voice;
+    voice.pcm = pcm;
+    voice.volume = volume;
+    voice.triggeredNs = m_clock.nsecsElapsed();
+    m_voices.append(voice);
+    return true;
+}
+
+int SoundMixerDevice::getVoiceCount() const {
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_voices.size());
+}
+
+SoundMixerDevice::Stats SoundMixerDevice::getStats() const {
+    QMutexLocker locker(&m_mutex);
+    Stats stats;
+    stats.triggers = m_triggers;
+    stats.dropped = m_dropped;
+    stats.averageLatencyUs = m_latencySamples > 0
+        ? static_cast<qint64>(m_totalLatencyNs / static_cast<qint64>(m_latencySamples)) / 1000
+        : 0;
+    stats.maxLatencyUs = m_maxLatencyNs / 1000;
+    return stats;
+}
+
+bool SoundMixerDevice::isSequential() const {
+    return true;
+}
+
+qint64 SoundMixerDevice::bytesAvailable() const {
+    // Silence is always available; the sink decides how much to pull.
+    return std::numeric_limits<int>::max() + QIODevice::bytesAvailable();
+}
+
+qint64 SoundMixerDevice::readData(char* data, qint64 maxSize) {
+    std::function<void()> onIdle;
+    QMutexLocker locker(&m_mutex);
+    const qint64 bytes = maxSize - maxSize % m_frameBytes;
+    const qsizetype sampleCount = static_cast<qsizetype>(bytes / static_cast<qint64>(sizeof(qint16)));
+    const bool hadVoices = !m_voices.isEmpty();
+    m_accumulator.assign(static_cast<size_t>(sampleCount), 0);
+    const qint64 nowNs = m_clock.nsecsElapsed();
+    for (auto it = m_voices.begin(); it != m_voices.end();) {
+        Voice& voice = *it;
+        if (voice.offset == 0) {
+            const qint64 latencyNs = nowNs - voice.triggeredNs;
+            ++m_latencySamples;
+            m_totalLatencyNs += latencyNs;
+            m_maxLatencyNs = qMax(m_maxLatencyNs, latencyNs);
+        }
+        const auto* samples = reinterpret_cast<const qint16*>(voice.pcm.constData()) + voice.offset;
+        const qsizetype remaining = voice.pcm.size() / static_cast<qsizetype>(sizeof(qint16)) - voice.offset;
+        const qsizetype mixed = qMin(remaining, sampleCount);
+        for (qsizetype i = 0; i < mixed; ++i) {
+            m_accumulator[static_cast<size_t>(i)] += static_cast<qint32>(samples[i] * voice.volume);
+        }
+        voice.offset += mixed;
+        it = voice.offset * static_cast<qsizetype>(sizeof(qint16)) >= voice.pcm.size() ? m_voices.erase(it) : it + 1;
+    }
+    auto* out = reinterpret_cast<qint16*>(data);
+    for (qsizetype i = 0; i < sampleCount; ++i) {
+        out[i] = static_cast<qint16>(std::clamp<qint32>(m_accumulator[static_cast<size_t>(i)],
+                                                        std::numeric_limits<qint16>::min(),
+                                                        std::numeric_limits<qint16>::max()));
+    }
+    if (hadVoices && m_voices.isEmpty()) {
+        onIdle = m_onIdle;
+    }
+    locker.unlock();
+    if (onIdle) {
+        onIdle();
+    }
+    return bytes;
+}
+
+qint64 SoundMixerDevice::writeData(const char* data, qint64 maxSize) {
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
@@ -15,6 +15,9 @@ size_t TextureResource::getSize() const {
     if (m_state != State::Loaded) {
         return 0;
     }
+    if (!m_image.isNull()) {
+        return static_cast<size_t>(m_image.sizeInBytes());
+    }
     return static_cast<size_t>(m_width * m_height * 4);
 }
 
@@ -33,3 +36,15 @@ void TextureResource::setDimensions(int width, int height) {
     m_width = width;
     m_height = height;
 }
+
+QImage TextureResource::getImage() const {
+    QReadLocker lock(&m_lock);
+    return m_image;
+}
+
+void TextureResource::setImage(const QImage& image) {
+    QWriteLocker lock(&m_lock);
+    m_image = image;
+    m_width = image.width();
+    m_height = image.height();
+}
@@ -8,6 +8,7 @@ CharacterItem::CharacterItem(QObject* parent)
 
 void CharacterItem::setPortrait(const QString& portrait) {
     m_portrait = portrait;
+    m_portraitHandle = ResourceHandle(portrait);
 }
 
 const QString& CharacterItem::getPortrait() const {
@@ -30,6 +31,22 @@ bool CharacterItem::isVisible() const {
     return m_visible;
 }
 
+void CharacterItem::initialize() {
+    if (!m_portraitHandle.isValid()) {
+        m_portraitHandle = ResourceHandle(m_portrait);
+    }
+    Item::initialize();
+}
+
+void CharacterItem::cleanup() {
+    m_portraitHandle.reset();
+    Item::cleanup();
+}
+
+QStringList CharacterItem::getResourceSources() const {
+    return m_portrait.isEmpty() ? QStringList() : QStringList { m_portrait };
+}
+
 QString CharacterItem::getType() const {
     return "Character";
 }
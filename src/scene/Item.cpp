@@ -41,6 +41,14 @@ void Item::fixedUpdate() {
     // Use Execution::getInstance().getFixedUpdateInterval() to get the interval
 }
 
+bool Item::hasPendingWork() const {
+    return false;
+}
+
+QStringList Item::getResourceSources() const {
+    return {};
+}
+
 void Item::cleanup() {
     m_initialized = false;
 }
@@ -1,12 +1,21 @@
 #include "scene/PlayableItem.h"
 
+#include "resources/MediaPlayerPool.h"
+
+#include <QDebug>
+
 PlayableItem::PlayableItem(QObject* parent)
     : Item(parent)
     , m_loop(false)
     , m_playing(false)
+    , m_player(nullptr)
 {
 }
 
+PlayableItem::~PlayableItem() {
+    releasePlayer();
+}
+
 QString PlayableItem::getSource() const {
     return m_source;
 }
@@ -16,6 +25,7 @@ void PlayableItem::setSource(const QString& source) {
         return;
     }
     m_source = source;
+    m_sourceHandle = ResourceHandle(source);
     emit sourceChanged();
 }
 
@@ -28,6 +38,9 @@ void PlayableItem::setLoop(bool loop) {
         return;
     }
     m_loop = loop;
+    if (m_player != nullptr) {
+        m_player->setLoops(m_loop ? QMediaPlayer::Infinite : 1);
+    }
     emit loopChanged();
 }
 
@@ -35,10 +48,25 @@ bool PlayableItem::isPlaying() const {
     return m_playing;
 }
 
+QMediaPlayer* PlayableItem::getPlayer() const {
+    return m_player;
+}
+
 void PlayableItem::play() {
     if (m_playing) {
         return;
     }
+    m_player = MediaPlayerPool::getInstance().acquire();
+    if (m_player != nullptr) {
+        m_player->setSource(MediaPlayerPool::toMediaUrl(m_sourceHandle.isValid() ? m_sourceHandle.getUrl() : m_source));
+        m_player->setLoops(m_loop ? QMediaPlayer::Infinite : 1);
+        m_playerConnection = connect(m_player, &QMediaPlayer::playbackStateChanged,
+                                     this, &PlayableItem::handlePlaybackStateChanged);
+        m_player->play();
+        emit playerChanged();
+    } else {
+        qWarning() << "No media player available for" << m_id;
+    }
     m_playing = true;
     emit playingChanged();
     emit playRequested();
@@ -48,7 +76,42 @@ void PlayableItem::stop() {
     if (!m_playing) {
         return;
     }
+    releasePlayer();
     m_playing = false;
     emit playingChanged();
     emit stopRequested();
 }
+
+void PlayableItem::initialize() {
+    if (!m_sourceHandle.isValid()) {
+        m_sourceHandle = ResourceHandle(m_source);
+    }
+    Item::initialize();
+}
+
+void PlayableItem::cleanup() {
+    stop();
+    m_sourceHandle.reset();
+    Item::cleanup();
+}
+
+QStringList PlayableItem::getResourceSources() const {
+    return m_source.isEmpty() ? QStringList() : QStringList { m_source };
+}
+
+void PlayableItem::releasePlayer() {
+    if (m_player == nullptr) {
+        return;
+    }
+    disconnect(m_playerConnection);
+    MediaPlayerPool::getInstance().release(m_player);
+    m_player = nullptr;
+    emit playerChanged();
+}
+
+void PlayableItem::handlePlaybackStateChanged(QMediaPlayer::PlaybackState state) {
+    // Reaching the end of a non-looping source frees the player for others.
+    if (state == QMediaPlayer::StoppedState) {
+        stop();
+    }
+}
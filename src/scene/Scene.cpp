@@ -1,20 +1,92 @@
 #include "scene/Scene.h"
+#include "core/Configuration.h"
 #include "factory/Registration.h"
+#include "resources/ResourceWatcher.h"
+#include "scene/CompiledSceneFormat.h"
+#include "scene/SceneStreamParser.h"
 
+#include <QCborStreamReader>
+#include <QCborValue>
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QSet>
 
 namespace {
+constexpr int DefaultStreamingThresholdKb = 1024;
+
 QString normalizeScenePath(const QString& filePath) {
     if (filePath.startsWith("qrc:/")) {
         return ":" + filePath.mid(4);
     }
     return filePath;
 }
+
+QString compiledScenePath(const QString& jsonUrl) {
+    return jsonUrl.left(jsonUrl.size() - QFileInfo(jsonUrl).suffix().size()) + QStringLiteral("cbor");
+}
+
+PropertyMap itemPropertiesFromJson(const QJsonObject& itemObject) {
+    PropertyMap properties;
+    properties["type"] = itemObject.value("type").toString();
+    properties["id"] = itemObject.value("id").toString();
+    properties["name"] = itemObject.value("name").toString();
+    const QJsonObject itemProperties = itemObject.value("properties").toObject();
+    for (auto it = itemProperties.begin(); it != itemProperties.end(); ++it) {
+        properties[it.key()] = it.value().toVariant();
+    }
+    return properties;
+}
+
+// Items without a type are built as plain Items; returns true when defaulted.
+bool applyDefaultItemType(PropertyMap& properties) {
+    if (!properties.value("type").toString().isEmpty()) {
+        return false;
+    }
+    properties["type"] = QStringLiteral("Item");
+    return true;
+}
+
+// Concatenates a (possibly chunked) CBOR text string; other values are skipped.
+QString readCborString(QCborStreamReader& reader) {
+    if (!reader.isString()) {
+        reader.next();
+        return {};
+    }
+    QString result;
+    auto chunk = reader.readString();
+    while (chunk.status == QCborStreamReader::Ok) {
+        result += chunk.data;
+        chunk = reader.readString();
+    }
+    return result;
+}
+
+// True if the compiled scene was built from the JSON as it is now.
+bool isCompiledSceneCurrent(const QString& jsonUrl, const QString& compiledUrl) {
+    // Embedded scenes are compiled by the build from the JSON embedded next
+    // to them, so only loose files, which can be edited, pay for the hash.
+    if (jsonUrl.startsWith("qrc:/") || jsonUrl.startsWith(":/")) {
+        return true;
+    }
+    QFile json(normalizeScenePath(jsonUrl));
+    QFile compiled(normalizeScenePath(compiledUrl));
+    if (!json.open(QIODevice::ReadOnly) || !compiled.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    // scenec writes the hash as the first entry of the root map.
+    QCborStreamReader reader(&compiled);
+    if (!reader.isMap() || !reader.enterContainer() || !reader.hasNext()
+        || readCborString(reader) != QLatin1String(CompiledSceneFormat::SourceHashKey)) {
+        return false;
+    }
+    const QString storedHash = readCborString(reader);
+    return reader.lastError() == QCborError::NoError
+        && storedHash.toLatin1() == CompiledSceneFormat::sourceHash(json.readAll());
+}
 }
 
 Scene::Scene(QObject* parent)
@@ -71,6 +143,7 @@ bool Scene::removeItem(const QString& itemId) {
 
     // Remove from map
     m_itemMap.erase(mapIt);
+    m_itemProperties.remove(itemId);
 
     return true;
 }
@@ -88,19 +161,116 @@ const QList<QSharedPointer<Item>>& Scene::getItems() const {
 }
 
 bool Scene::load(const QString& url) {
+    m_sourceUrl = url;
     const QString suffix = QFileInfo(url).suffix().toLower();
     if (suffix == "json") {
+        const QString compiledUrl = compiledScenePath(url);
+        if (QFile::exists(normalizeScenePath(compiledUrl))) {
+            if (isCompiledSceneCurrent(url, compiledUrl)) {
+                return loadFromCbor(compiledUrl);
+            }
+            qWarning() << "Compiled scene is stale, parsing the JSON instead:" << compiledUrl;
+        }
         return loadFromJson(url);
     }
+    if (suffix == "cbor") {
+        return loadFromCbor(url);
+    }
     return loadFromQml(url);
 }
 
+const QString& Scene::getSourceUrl() const {
+    return m_sourceUrl;
+}
+
+bool Scene::readJsonItems(const QString& filePath, QList<PropertyMap>& items) {
+    QFile file(normalizeScenePath(filePath));
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open scene JSON:" << filePath;
+        return false;
+    }
+    SceneStreamParser parser(
+        [](const QString&) {},
+        [&items](const QJsonObject& itemObject) {
+            PropertyMap properties = itemPropertiesFromJson(itemObject);
+            applyDefaultItemType(properties);
+            items.append(properties);
+        });
+    if (!parser.parse(file)) {
+        qWarning() << "Failed to parse scene JSON:" << filePath << parser.getErrorString();
+        return false;
+    }
+    return true;
+}
+
+int Scene::applyChangedItems(const QList<PropertyMap>& items) {
+    int changedCount = 0;
+    int unmatchedCount = 0;
+    QSet<QString> seenIds;
+    for (const PropertyMap& properties : items) {
+        const QString itemId = properties.value("id").toString();
+        if (itemId.isEmpty()) {
+            ++unmatchedCount;
+            continue;
+        }
+        if (seenIds.contains(itemId)) {
+            continue;
+        }
+        seenIds.insert(itemId);
+        const auto previous = m_itemProperties.constFind(itemId);
+        if (previous != m_itemProperties.constEnd() && previous.value() == properties) {
+            continue;
+        }
+        if (replaceItem(itemId, properties)) {
+            ++changedCount;
+        }
+    }
+    const QStringList knownIds = m_itemProperties.keys();
+    for (const QString& itemId : knownIds) {
+        if (!seenIds.contains(itemId) && removeItem(itemId)) {
+            ++changedCount;
+        }
+    }
+    if (unmatchedCount > 0) {
+        qWarning() << "Hot reload of scene" << getId() << "skipped" << unmatchedCount
+                   << "items without an id; give them one to reload their edits";
+    }
+    return changedCount;
+}
+
+bool Scene::replaceItem(const QString& itemId, const PropertyMap& properties) {
+    const QSharedPointer<Item> item = instantiateItem(properties);
+    if (item.isNull()) {
+        return false;
+    }
+    const QSharedPointer<Item> previous = m_itemMap.value(itemId);
+    const qsizetype index = previous.isNull() ? -1 : m_items.indexOf(previous);
+    if (index >= 0) {
+        previous->cleanup();
+        m_items[index] = item;
+    } else {
+        m_items.append(item);
+    }
+    m_itemMap[itemId] = item;
+    m_itemProperties[itemId] = properties;
+    if (m_initialized) {
+        item->initialize();
+    }
+    return true;
+}
+
 bool Scene::loadFromJson(const QString& filePath) {
     QFile file(normalizeScenePath(filePath));
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Failed to open scene JSON:" << filePath;
         return false;
     }
+    const qint64 streamingThresholdBytes = static_cast<qint64>(Configuration::getInstance()
+        .getValue(QStringLiteral("scene.streaming_threshold_kb"), DefaultStreamingThresholdKb)
+        .toInt()) * 1024;
+    if (file.size() > streamingThresholdBytes) {
+        return loadFromJsonStream(file, filePath);
+    }
     const QByteArray data = file.readAll();
     file.close();
 
@@ -113,42 +283,145 @@ bool Scene::loadFromJson(const QString& filePath) {
 
     const QJsonObject root = document.object();
     const QJsonObject sceneObject = root.value("scene").toObject();
-    const QString parsedId = sceneObject.value("id").toString();
-    if (!parsedId.isEmpty()) {
-        setId(parsedId);
-    } else if (getId().isEmpty()) {
-        setId(QFileInfo(filePath).completeBaseName());
-    }
+    applySceneId(sceneObject.value("id").toString(), filePath);
 
     const QJsonArray items = sceneObject.value("items").toArray();
     for (const QJsonValue& value : items) {
-        const QJsonObject itemObject = value.toObject();
-        const QString itemType = itemObject.value("type").toString();
-        if (itemType.isEmpty()) {
-            qWarning() << "Scene item missing type in scene:" << getId() << "- falling back to Item";
-        }
-        PropertyMap properties;
-        properties["type"] = itemType.isEmpty() ? QStringLiteral("Item") : itemType;
-        properties["id"] = itemObject.value("id").toString();
-        properties["name"] = itemObject.value("name").toString();
-        const QJsonObject itemProperties = itemObject.value("properties").toObject();
-        for (auto it = itemProperties.begin(); it != itemProperties.end(); ++it) {
-            properties[it.key()] = it.value().toVariant();
+        PropertyMap properties = itemPropertiesFromJson(value.toObject());
+        createItem(properties);
+    }
+
+    return true;
+}
+
+bool Scene::loadFromJsonStream(QIODevice& device, const QString& filePath) {
+    QString parsedId;
+    SceneStreamParser parser(
+        [this, &parsedId, &filePath](const QString& sceneId) {
+            parsedId = sceneId;
+            applySceneId(parsedId, filePath);
+        },
+        [this](const QJsonObject& itemObject) {
+            PropertyMap properties = itemPropertiesFromJson(itemObject);
+            createItem(properties);
+        });
+    const bool parsed = parser.parse(device);
+    applySceneId(parsedId, filePath);
+    if (!parsed) {
+        qWarning() << "Failed to stream scene JSON:" << filePath << parser.getErrorString();
+    }
+    return parsed;
+}
+
+bool Scene::loadFromCbor(const QString& filePath) {
+    QFile file(normalizeScenePath(filePath));
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open compiled scene:" << filePath;
+        return false;
+    }
+
+    // Walks the stream directly into PropertyMaps; only individual property
+    // values are materialised (as QCborValue) on the way.
+    QCborStreamReader reader(&file);
+    if (!reader.isMap() || !reader.enterContainer()) {
+        qWarning() << "Compiled scene root is not a map:" << filePath;
+        return false;
+    }
+    QString parsedId;
+    while (reader.hasNext() && reader.lastError() == QCborError::NoError) {
+        if (readCborString(reader) != QStringLiteral("scene") || !reader.isMap()) {
+            reader.next();
+            continue;
         }
-        const QSharedPointer<QObject> object = Registration::getInstance().create("Native", properties);
-        const QSharedPointer<Item> item = object.dynamicCast<Item>();
-        if (!item.isNull()) {
-            addItem(item);
-        } else {
-            qWarning() << "Failed to create scene item: scene=" << getId()
-                       << ", itemId=" << itemObject.value("id").toString()
-                       << ", type=" << properties["type"].toString();
+        reader.enterContainer();
+        while (reader.hasNext() && reader.lastError() == QCborError::NoError) {
+            const QString sceneKey = readCborString(reader);
+            if (sceneKey == QStringLiteral("id")) {
+                parsedId = readCborString(reader);
+                continue;
+            }
+            if (sceneKey != QStringLiteral("items") || !reader.isArray()) {
+                reader.next();
+                continue;
+            }
+            // Items may reference the scene id in warnings, so settle it first.
+            applySceneId(parsedId, filePath);
+            reader.enterContainer();
+            while (reader.hasNext() && reader.lastError() == QCborError::NoError) {
+                if (!reader.isMap()) {
+                    reader.next();
+                    continue;
+                }
+                PropertyMap properties;
+                properties["type"] = QString();
+                properties["id"] = QString();
+                properties["name"] = QString();
+                PropertyMap itemProperties;
+                reader.enterContainer();
+                while (reader.hasNext() && reader.lastError() == QCborError::NoError) {
+                    const QString itemKey = readCborString(reader);
+                    if (itemKey == QStringLiteral("properties") && reader.isMap()) {
+                        reader.enterContainer();
+                        while (reader.hasNext() && reader.lastError() == QCborError::NoError) {
+                            const QString propertyKey = readCborString(reader);
+                            itemProperties[propertyKey] = QCborValue::fromCbor(reader).toVariant();
+                        }
+                        reader.leaveContainer();
+                    } else if (properties.contains(itemKey)) {
+                        properties[itemKey] = readCborString(reader);
+                    } else {
+                        reader.next();
+                    }
+                }
+                reader.leaveContainer();
+                // Same precedence as the JSON path: "properties" entries win.
+                properties.insert(itemProperties);
+                createItem(properties);
+            }
+            reader.leaveContainer();
         }
+        reader.leaveContainer();
     }
+    applySceneId(parsedId, filePath);
 
+    if (reader.lastError() != QCborError::NoError) {
+        qWarning() << "Failed to parse compiled scene:" << filePath << reader.lastError().toString();
+        return false;
+    }
     return true;
 }
 
+void Scene::applySceneId(const QString& parsedId, const QString& filePath) {
+    if (!parsedId.isEmpty()) {
+        setId(parsedId);
+    } else if (getId().isEmpty()) {
+        setId(QFileInfo(filePath).completeBaseName());
+    }
+}
+
+void Scene::createItem(PropertyMap& properties) {
+    if (applyDefaultItemType(properties)) {
+        qWarning() << "Scene item missing type in scene:" << getId() << "- falling back to Item";
+    }
+    const QSharedPointer<Item> item = instantiateItem(properties);
+    // Only hot reload compares against these; large scenes would otherwise
+    // hold every item's properties twice.
+    if (!item.isNull() && addItem(item) && !item->getId().isEmpty() && ResourceWatcher::getInstance().isEnabled()) {
+        m_itemProperties.insert(item->getId(), properties);
+    }
+}
+
+QSharedPointer<Item> Scene::instantiateItem(const PropertyMap& properties) const {
+    const QSharedPointer<QObject> object = Registration::getInstance().create("Native", properties);
+    const QSharedPointer<Item> item = object.dynamicCast<Item>();
+    if (item.isNull()) {
+        qWarning() << "Failed to create scene item: scene=" << getId()
+                   << ", itemId=" << properties.value("id").toString()
+                   << ", type=" << properties.value("type").toString();
+    }
+    return item;
+}
+
 bool Scene::loadFromQml(const QString& filePath) {
     const QString normalizedPath = normalizeScenePath(filePath);
     if (!QFile::exists(normalizedPath)) {
@@ -162,6 +435,7 @@ bool Scene::loadFromQml(const QString& filePath) {
 }
 
 void Scene::initialize() {
+    Item::initialize();
     for (auto& item : m_items) {
         if (item) {
             item->initialize();
@@ -185,6 +459,15 @@ void Scene::fixedUpdate() {
     }
 }
 
+bool Scene::hasPendingWork() const {
+    for (const auto& item : m_items) {
+        if (item && item->hasPendingWork()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void Scene::clear() {
     for (auto& item : m_items) {
         if (item) {
@@ -193,6 +476,7 @@ void Scene::clear() {
     }
     m_items.clear();
     m_itemMap.clear();
+    m_itemProperties.clear();
 }
 
 QString Scene::getType() const {
@@ -0,0 +1,177 @@
+#include "scene/SceneStreamParser.h"
+
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <utility>
+
+namespace {
+constexpr qint64 ReadChunkBytes = 64 * 1024;
+// Depth of an element of scene.items: root object, scene object, items array.
+constexpr qsizetype ItemsArrayDepth = 3;
+
+QString decodeJsonString(const QByteArray& raw) {
+    if (!raw.contains('\\')) {
+        return QString::fromUtf8(raw);
+    }
+    // Escapes are rare in keys and ids; let the JSON parser deal with them.
+    const QJsonDocument wrapper = QJsonDocument::fromJson("[\"" + raw + "\"]");
+    return wrapper.array().at(0).toString();
+}
+}
+
+SceneStreamParser::SceneStreamParser(SceneIdHandler onSceneId, ItemHandler onItem)
+    : m_onSceneId(std::move(onSceneId))
+    , m_onItem(std::move(onItem))
+    , m_inString(false)
+    , m_escape(false)
+    , m_stringIsKey(false)
+    , m_inItem(false)
+{
+}
+
+bool SceneStreamParser::parse(QIODevice& device) {
+    QByteArray chunk(ReadChunkBytes, Qt::Uninitialized);
+    while (true) {
+        const qint64 bytesRead = device.read(chunk.data(), ReadChunkBytes);
+        if (bytesRead < 0) {
+            return fail(QStringLiteral("read error: ") + device.errorString());
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+        if (!feed(chunk.constData(), static_cast<qsizetype>(bytesRead))) {
+            return false;
+        }
+    }
+    if (!m_stack.isEmpty() || m_inString) {
+        return fail(QStringLiteral("unexpected end of file"));
+    }
+    return true;
+}
+
+const QString& SceneStreamParser::getErrorString() const {
+    return m_errorString;
+}
+
+bool SceneStreamParser::feed(const char* data, qsizetype size) {
+    qsizetype itemStart = m_inItem ? 0 : -1;
+    for (qsizetype i = 0; i < size; ++i) {
+        const char c = data[i];
+        if (m_inString) {
+            if (m_escape) {
+                m_escape = false;
+            } else if (c == '\\') {
+                m_escape = true;
+            } else if (c == '"') {
+                m_inString = false;
+                if (!m_inItem) {
+                    finishString();
+                }
+                continue;
+            }
+            if (!m_inItem) {
+                m_string.append(c);
+            }
+            continue;
+        }
+
+        switch (c) {
+        case '"':
+            m_inString = true;
+            m_string.clear();
+            m_stringIsKey = !m_stack.isEmpty() && m_stack.constLast().type == '{' && m_stack.constLast().expectKey;
+            break;
+        case '{':
+        case '[':
+            if (!m_inItem && c == '{' && isItemsArray()) {
+                m_inItem = true;
+                itemStart = i;
+            }
+            if (!openContainer(c)) {
+                return false;
+            }
+            break;
+        case '}':
+        case ']':
+            if (!closeContainer(c == '}' ? '{' : '[')) {
+                return false;
+            }
+            if (m_inItem && m_stack.size() == ItemsArrayDepth) {
+                m_itemBuffer.append(data + itemStart, i + 1 - itemStart);
+                QJsonParseError parseError;
+                const QJsonDocument item = QJsonDocument::fromJson(m_itemBuffer, &parseError);
+                if (parseError.error != QJsonParseError::NoError || !item.isObject()) {
+                    return fail(QStringLiteral("bad scene item: ") + parseError.errorString());
+                }
+                m_itemBuffer.clear();
+                m_inItem = false;
+                itemStart = -1;
+                m_onItem(item.object());
+            }
+            break;
+        case ':':
+            if (!m_stack.isEmpty()) {
+                m_stack.last().expectKey = false;
+            }
+            break;
+        case ',':
+            if (!m_stack.isEmpty() && m_stack.constLast().type == '{') {
+                m_stack.last().expectKey = true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    // Carry the open item's bytes over to the next chunk.
+    if (m_inItem && itemStart >= 0) {
+        m_itemBuffer.append(data + itemStart, size - itemStart);
+    }
+    return true;
+}
+
+bool SceneStreamParser::openContainer(char type) {
+    Frame frame;
+    frame.type = type;
+    frame.expectKey = type == '{';
+    m_stack.append(frame);
+    return true;
+}
+
+bool SceneStreamParser::closeContainer(char type) {
+    if (m_stack.isEmpty() || m_stack.constLast().type != type) {
+        return fail(QStringLiteral("mismatched brackets"));
+    }
+    m_stack.removeLast();
+    return true;
+}
+
+void SceneStreamParser::finishString() {
+    if (m_stringIsKey) {
+        m_stack.last().key = m_string;
+        return;
+    }
+    if (isSceneIdValue()) {
+        m_onSceneId(decodeJsonString(m_string));
+    }
+}
+
+bool SceneStreamParser::isItemsArray() const {
+    return m_stack.size() == ItemsArrayDepth
+        && m_stack[0].type == '{' && m_stack[0].key == "scene"
+        && m_stack[1].type == '{' && m_stack[1].key == "items"
+        && m_stack[2].type == '[';
+}
+
+bool SceneStreamParser::isSceneIdValue() const {
+    return m_stack.size() == 2
+        && m_stack[0].key == "scene"
+        && m_stack[1].type == '{' && m_stack[1].key == "id";
+}
+
+bool SceneStreamParser::fail(const QString& error) {
+    m_errorString = error;
+    return false;
+}
@@ -0,0 +1,157 @@
+#include "resources/AssetPackFormat.h"
+#include "resources/FormatSupport.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+struct PackInput {
+    QString path;
+    QByteArray utf8Path;
+    QString filePath;
+    quint64 pathHash = 0;
+};
+
+AssetPackFormat::TypeHint typeHintForSuffix(const QString& suffix) {
+    if (supportedImageSuffixes().contains(suffix)) {
+        return AssetPackFormat::TypeHint::Image;
+    }
+    if (suffix == QStringLiteral("json")) {
+        return AssetPackFormat::TypeHint::Json;
+    }
+    if (suffix == QStringLiteral("qml")) {
+        return AssetPackFormat::TypeHint::Qml;
+    }
+    return AssetPackFormat::TypeHint::Media;
+}
+
+bool comparePathHash(const PackInput& left, const PackInput& right) {
+    return left.pathHash < right.pathHash;
+}
+
+bool writePadding(QFile& output, qint64 alignedOffset) {
+    const qint64 padding = alignedOffset - output.pos();
+    if (padding <= 0) {
+        return true;
+    }
+    return output.write(QByteArray(padding, '\0')) == padding;
+}
+
+QList<PackInput> collectInputs(const QString& inputDir) {
+    QList<PackInput> inputs;
+    const QDir root(inputDir);
+    QDirIterator it(inputDir, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString filePath = it.next();
+        PackInput input;
+        input.path = root.relativeFilePath(filePath);
+        input.utf8Path = input.path.toUtf8();
+        input.filePath = filePath;
+        input.pathHash = AssetPackFormat::hash(input.utf8Path);
+        inputs.append(input);
+    }
+    std::sort(inputs.begin(), inputs.end(), comparePathHash);
+    return inputs;
+}
+
+bool writePack(const QString& outputPath, const QList<PackInput>& inputs) {
+    QByteArray strings;
+    QList<AssetPackFormat::IndexEntry> index(inputs.size());
+    for (qsizetype i = 0; i < inputs.size(); ++i) {
+        std::memset(&index[i], 0, sizeof(AssetPackFormat::IndexEntry));
+        index[i].pathHash = inputs[i].pathHash;
+        index[i].pathOffset = static_cast<quint32>(strings.size());
+        index[i].pathLength = static_cast<quint32>(inputs[i].utf8Path.size());
+        index[i].typeHint = static_cast<quint32>(typeHintForSuffix(QFileInfo(inputs[i].path).suffix().toLower()));
+        strings.append(inputs[i].utf8Path);
+    }
+
+    const qint64 indexOffset = static_cast<qint64>(sizeof(AssetPackFormat::Header));
+    const qint64 stringsOffset = indexOffset + static_cast<qint64>(index.size() * sizeof(AssetPackFormat::IndexEntry));
+    const qint64 dataOffset = AssetPackFormat::alignUp(stringsOffset + strings.size());
+
+    QFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to create pack:" << outputPath << output.errorString();
+        return false;
+    }
+
+    // Index entries need payload offsets, so the header/index region is skipped,
+    // payloads are written first, and the header/index are filled in last.
+    if (!output.seek(dataOffset)) {
+        return false;
+    }
+    for (qsizetype i = 0; i < inputs.size(); ++i) {
+        QFile input(inputs[i].filePath);
+        if (!input.open(QIODevice::ReadOnly)) {
+            qWarning() << "Failed to read input:" << inputs[i].filePath;
+            return false;
+        }
+        const QByteArray payload = input.readAll();
+        if (!writePadding(output, AssetPackFormat::alignUp(output.pos()))) {
+            return false;
+        }
+        index[i].dataOffset = static_cast<quint64>(output.pos());
+        index[i].dataSize = static_cast<quint64>(payload.size());
+        index[i].contentHash = AssetPackFormat::hash(payload);
+        if (output.write(payload) != payload.size()) {
+            qWarning() << "Failed to write payload:" << inputs[i].path;
+            return false;
+        }
+    }
+
+    AssetPackFormat::Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, AssetPackFormat::Magic, sizeof(header.magic));
+    header.version = AssetPackFormat::Version;
+    header.entryCount = static_cast<quint32>(index.size());
+    header.indexOffset = static_cast<quint64>(indexOffset);
+    header.stringsOffset = static_cast<quint64>(stringsOffset);
+
+    const qint64 indexBytes = static_cast<qint64>(index.size() * sizeof(AssetPackFormat::IndexEntry));
+    const bool headerWritten = output.seek(0)
+        && output.write(reinterpret_cast<const char*>(&header), sizeof(header)) == static_cast<qint64>(sizeof(header))
+        && output.write(reinterpret_cast<const char*>(index.constData()), indexBytes) == indexBytes
+        && output.write(strings) == strings.size();
+    if (!headerWritten) {
+        qWarning() << "Failed to write pack index:" << outputPath;
+        return false;
+    }
+    qDebug() << "Packed" << inputs.size() << "files into" << outputPath << "(" << output.size() << "bytes )";
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("qt-galgame-packer"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Builds a memory-mappable asset pack from a directory."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("input"), QStringLiteral("Directory to pack."));
+    parser.addPositionalArgument(QStringLiteral("output"), QStringLiteral("Pack file to write."));
+    parser.process(app);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() != 2) {
+        parser.showHelp(1);
+    }
+    const QString inputDir = arguments.at(0);
+    if (!QFileInfo(inputDir).isDir()) {
+        qWarning() << "Input is not a directory:" << inputDir;
+        return 1;
+    }
+    return writePack(arguments.at(1), collectInputs(inputDir)) ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+#include "resources/JsonResource.h"
+#include "resources/QmlResource.h"
+#include "resources/TextureResource.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QVariant>
+
+#include <functional>
+
+namespace {
+
+// Keeps the optimiser from discarding the accessed payloads.
+volatile qint64 g_sink = 0;
+
+qint64 timePerAccessNs(int iterations, const std::function<qint64()>& access) {
+    QElapsedTimer timer;
+    timer.start();
+    qint64 checksum = 0;
+    for (int i = 0; i < iterations; ++i) {
+        checksum += access();
+    }
+    g_sink = g_sink + checksum;
+    return timer.nsecsElapsed() / iterations;
+}
+
+void report(const char* payload, qint64 legacyNs, qint64 typedNs) {
+    qDebug().noquote() << QStringLiteral("%1 QObject property %2 ns/access, typed accessor %3 ns/access")
+                              .arg(QLatin1String(payload), -8)
+                              .arg(legacyNs, 8)
+                              .arg(typedNs, 6);
+}
+
+QJsonDocument makeSceneDocument(int itemCount) {
+    QJsonArray items;
+    for (int i = 0; i < itemCount; ++i) {
+        QJsonObject properties;
+        properties.insert(QStringLiteral("shot"), i % 7 + 1);
+        properties.insert(QStringLiteral("text"), QStringLiteral("line %1").arg(i));
+        QJsonObject item;
+        item.insert(QStringLiteral("type"), QStringLiteral("Item"));
+        item.insert(QStringLiteral("id"), QStringLiteral("item%1").arg(i));
+        item.insert(QStringLiteral("properties"), properties);
+        items.append(item);
+    }
+    QJsonObject scene;
+    scene.insert(QStringLiteral("id"), QStringLiteral("bench"));
+    scene.insert(QStringLiteral("items"), items);
+    QJsonObject root;
+    root.insert(QStringLiteral("scene"), scene);
+    return QJsonDocument(root);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("qt-galgame-accessbench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+        "Compares reading resource payloads through QObject dynamic properties "
+        "(the former loader output) with the typed resource accessors."));
+    parser.addHelpOption();
+    const QCommandLineOption iterationsOption(QStringLiteral("iterations"), QStringLiteral("Accesses per case."),
+                                              QStringLiteral("count"), QStringLiteral("100000"));
+    const QCommandLineOption itemsOption(QStringLiteral("json-items"), QStringLiteral("Items in the JSON payload."),
+                                         QStringLiteral("count"), QStringLiteral("200"));
+    parser.addOption(iterationsOption);
+    parser.addOption(itemsOption);
+    parser.process(app);
+
+    const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+    const int jsonItems = qMax(1, parser.value(itemsOption).toInt());
+    // JSON re-parsing is far slower than the other cases; fewer runs keep the total short.
+    const int jsonIterations = qMax(1, iterations / 100);
+
+    // Texture: a window-sized decoded image.
+    QImage image(1280, 720, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::darkCyan);
+    QObject legacyTexture;
+    legacyTexture.setProperty("image", image);
+    TextureResource texture(QStringLiteral("qrc:/bench.png"));
+    texture.setImage(image);
+    report("texture",
+           timePerAccessNs(iterations, [&]() {
+               return static_cast<qint64>(legacyTexture.property("image").value<QImage>().constBits()[0]);
+           }),
+           timePerAccessNs(iterations, [&]() {
+               return static_cast<qint64>(texture.getImage().constBits()[0]);
+           }));
+
+    // JSON: loaders stored compact text that every consumer parsed again.
+    const QJsonDocument document = makeSceneDocument(jsonItems);
+    QObject legacyJson;
+    legacyJson.setProperty("json", document.toJson(QJsonDocument::Compact));
+    JsonResource json(QStringLiteral("qrc:/bench.json"));
+    json.setDocument(document);
+    const auto itemCount = [](const QJsonDocument& doc) {
+        return static_cast<qint64>(doc.object().value(QStringLiteral("scene")).toObject()
+                                       .value(QStringLiteral("items")).toArray().size());
+    };
+    report("json",
+           timePerAccessNs(jsonIterations, [&]() {
+               return itemCount(QJsonDocument::fromJson(legacyJson.property("json").toByteArray()));
+           }),
+           timePerAccessNs(jsonIterations, [&]() {
+               return itemCount(json.getDocument());
+           }));
+
+    // QML: loaders stored a QString copy; the engine wants UTF-8 bytes.
+    const QByteArray qmlSource = QByteArrayLiteral("import QtQuick 2.15\nItem { width: 100; height: 100 }\n")
+        .repeated(64);
+    QObject legacyQml;
+    legacyQml.setProperty("qml", QString::fromUtf8(qmlSource));
+    QmlResource qml(QStringLiteral("qrc:/bench.qml"));
+    qml.setData(qmlSource);
+    report("qml",
+           timePerAccessNs(iterations, [&]() {
+               return static_cast<qint64>(legacyQml.property("qml").toString().toUtf8().size());
+           }),
+           timePerAccessNs(iterations, [&]() {
+               return static_cast<qint64>(qml.getData().size());
+           }));
+    return 0;
+}
@@ -0,0 +1,198 @@
+#include "resources/AssetPack.h"
+#include "resources/AssetPackFormat.h"
+#include "resources/ResourceManifestFormat.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+
+#include <algorithm>
+
+namespace {
+
+struct ManifestEntry {
+    QString url;
+    QString suffix;
+    qint64 size = 0;
+    quint64 contentHash = 0;
+};
+
+bool compareUrl(const ManifestEntry& left, const ManifestEntry& right) {
+    return left.url < right.url;
+}
+
+QString suffixOf(const QString& path) {
+    return QFileInfo(path).suffix().toLower();
+}
+
+QString qrcUrl(const QString& prefix, const QString& path) {
+    // Mirrors how QDirIterator reports ":/prefix/path", normalised to a qrc:/ URL.
+    const QString joined = QStringLiteral("/") + prefix + QStringLiteral("/") + path;
+    return QStringLiteral("qrc:") + QDir::cleanPath(joined);
+}
+
+bool collectQrc(const QString& qrcPath, QList<ManifestEntry>& entries) {
+    QFile qrcFile(qrcPath);
+    if (!qrcFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open qrc:" << qrcPath;
+        return false;
+    }
+    const QDir baseDir = QFileInfo(qrcPath).absoluteDir();
+    QXmlStreamReader xml(&qrcFile);
+    QString prefix;
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        if (xml.name() == QLatin1String("qresource")) {
+            prefix = xml.attributes().value(QLatin1String("prefix")).toString();
+            continue;
+        }
+        if (xml.name() != QLatin1String("file")) {
+            continue;
+        }
+        const QString alias = xml.attributes().value(QLatin1String("alias")).toString();
+        const QString relativePath = xml.readElementText().trimmed();
+        QFile input(baseDir.filePath(relativePath));
+        if (!input.open(QIODevice::ReadOnly)) {
+            qWarning() << "Failed to read qrc entry:" << input.fileName();
+            return false;
+        }
+        const QByteArray content = input.readAll();
+        ManifestEntry entry;
+        entry.url = qrcUrl(prefix, alias.isEmpty() ? relativePath : alias);
+        entry.suffix = suffixOf(entry.url);
+        entry.size = content.size();
+        entry.contentHash = AssetPackFormat::hash(content);
+        entries.append(entry);
+    }
+    if (xml.hasError()) {
+        qWarning() << "Failed to parse qrc:" << qrcPath << xml.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool collectQrcBase(const QString& basePath, QList<ManifestEntry>& entries) {
+    // Files added with qt_add_resources(... BASE basePath FILES ...) under the
+    // "/" prefix: each is embedded at its path relative to the base.
+    const QDir baseDir(basePath);
+    if (!baseDir.exists()) {
+        qWarning() << "qrc base directory does not exist:" << basePath;
+        return false;
+    }
+    QDirIterator it(baseDir.absolutePath(), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QFile input(it.next());
+        if (!input.open(QIODevice::ReadOnly)) {
+            qWarning() << "Failed to read qrc base entry:" << input.fileName();
+            return false;
+        }
+        const QByteArray content = input.readAll();
+        ManifestEntry entry;
+        entry.url = qrcUrl(QString(), baseDir.relativeFilePath(input.fileName()));
+        entry.suffix = suffixOf(entry.url);
+        entry.size = content.size();
+        entry.contentHash = AssetPackFormat::hash(content);
+        entries.append(entry);
+    }
+    return true;
+}
+
+bool collectPack(const QString& packPath, QList<ManifestEntry>& entries) {
+    AssetPack pack(packPath);
+    if (!pack.open()) {
+        return false;
+    }
+    const QString prefix = QString::fromLatin1(AssetPack::Protocol) + QStringLiteral("://");
+    const QStringList paths = pack.getPaths();
+    for (const QString& path : paths) {
+        ManifestEntry entry;
+        entry.url = prefix + path;
+        entry.suffix = suffixOf(path);
+        entry.size = pack.read(path).size();
+        entry.contentHash = pack.getContentHash(path);
+        entries.append(entry);
+    }
+    return true;
+}
+
+bool writeManifest(const QString& outputPath, QList<ManifestEntry>& entries) {
+    // Sorted output keeps the generated file stable across builds.
+    std::sort(entries.begin(), entries.end(), compareUrl);
+    QByteArray text;
+    text.append(ResourceManifestFormat::Magic).append(' ').append(QByteArray::number(ResourceManifestFormat::Version));
+    text.append('\n');
+    for (const ManifestEntry& entry : std::as_const(entries)) {
+        text.append(entry.url.toUtf8()).append(ResourceManifestFormat::FieldSeparator);
+        text.append(entry.suffix.toUtf8()).append(ResourceManifestFormat::FieldSeparator);
+        text.append(QByteArray::number(entry.size)).append(ResourceManifestFormat::FieldSeparator);
+        text.append(QByteArray::number(entry.contentHash, 16).rightJustified(16, '0'));
+        text.append('\n');
+    }
+
+    QDir().mkpath(QFileInfo(outputPath).absolutePath());
+    QSaveFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly) || output.write(text) != text.size() || !output.commit()) {
+        qWarning() << "Failed to write manifest:" << outputPath;
+        return false;
+    }
+    qDebug() << "Wrote" << entries.size() << "manifest entries to" << outputPath;
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("qt-galgame-manifest"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Generates the build-time resource manifest."));
+    parser.addHelpOption();
+    const QCommandLineOption qrcOption(QStringLiteral("qrc"), QStringLiteral("Qt resource collection to list."),
+                                       QStringLiteral("file"));
+    const QCommandLineOption qrcBaseOption(QStringLiteral("qrc-base"),
+                                           QStringLiteral("Directory whose files are all embedded under qrc:/."),
+                                           QStringLiteral("dir"));
+    const QCommandLineOption packOption(QStringLiteral("pack"), QStringLiteral("Asset pack to list."),
+                                        QStringLiteral("file"));
+    parser.addOption(qrcOption);
+    parser.addOption(qrcBaseOption);
+    parser.addOption(packOption);
+    parser.addPositionalArgument(QStringLiteral("output"), QStringLiteral("Manifest file to write."));
+    parser.process(app);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() != 1) {
+        parser.showHelp(1);
+    }
+
+    QList<ManifestEntry> entries;
+    const QStringList qrcFiles = parser.values(qrcOption);
+    for (const QString& qrcPath : qrcFiles) {
+        if (!collectQrc(qrcPath, entries)) {
+            return 1;
+        }
+    }
+    const QStringList qrcBases = parser.values(qrcBaseOption);
+    for (const QString& basePath : qrcBases) {
+        if (!collectQrcBase(basePath, entries)) {
+            return 1;
+        }
+    }
+    const QStringList packFiles = parser.values(packOption);
+    for (const QString& packPath : packFiles) {
+        if (!collectPack(packPath, entries)) {
+            return 1;
+        }
+    }
+    return writeManifest(arguments.at(0), entries) ? 0 : 1;
+}
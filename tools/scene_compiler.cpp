@@ -0,0 +1,62 @@
+#include "scene/CompiledSceneFormat.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+namespace {
+
+bool compileScene(const QString& inputPath, const QString& outputPath) {
+    QFile input(inputPath);
+    if (!input.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open scene:" << inputPath;
+        return false;
+    }
+    const QByteArray json = input.readAll();
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        qWarning() << "Failed to parse scene:" << inputPath << parseError.errorString();
+        return false;
+    }
+    if (!document.object().value("scene").isObject()) {
+        qWarning() << "Not a scene file (no \"scene\" object):" << inputPath;
+        return false;
+    }
+
+    const QByteArray cbor = CompiledSceneFormat::compile(document.object(), json);
+    QDir().mkpath(QFileInfo(outputPath).absolutePath());
+    QSaveFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly) || output.write(cbor) != cbor.size() || !output.commit()) {
+        qWarning() << "Failed to write compiled scene:" << outputPath;
+        return false;
+    }
+    qDebug() << "Compiled" << inputPath << "->" << outputPath << "(" << cbor.size() << "bytes )";
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("qt-galgame-scenec"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Compiles a JSON scene into the CBOR form Scene loads directly."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("input"), QStringLiteral("Scene JSON file."));
+    parser.addPositionalArgument(QStringLiteral("output"), QStringLiteral("Compiled .cbor file to write."));
+    parser.process(app);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() != 2) {
+        parser.showHelp(1);
+    }
+    return compileScene(arguments.at(0), arguments.at(1)) ? 0 : 1;
+}
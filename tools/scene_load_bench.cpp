@@ -0,0 +1,127 @@
+#include "factory/NativeItemFactory.h"
+#include "factory/Registration.h"
+#include "resources/Resources.h"
+#include "scene/CompiledSceneFormat.h"
+#include "scene/Scene.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+namespace {
+
+int intOption(const QCommandLineParser& parser, const QCommandLineOption& option, int fallback) {
+    bool ok = false;
+    const int value = parser.value(option).toInt(&ok);
+    return ok && value > 0 ? value : fallback;
+}
+
+QJsonObject makeScene(int itemCount) {
+    QJsonArray items;
+    for (int i = 0; i < itemCount; ++i) {
+        QJsonObject properties;
+        properties.insert(QStringLiteral("shot"), i % 7 + 1);
+        properties.insert(QStringLiteral("text"), QStringLiteral("line %1").arg(i));
+        QJsonObject item;
+        // Every fourth item is a character, like a dialogue-heavy scene.
+        if (i % 4 == 0) {
+            item.insert(QStringLiteral("type"), QStringLiteral("Character"));
+            properties.insert(QStringLiteral("source"), QStringLiteral("qrc:/images/char%1.png").arg(i % 3));
+            properties.insert(QStringLiteral("expression"), QStringLiteral("smile"));
+        } else {
+            item.insert(QStringLiteral("type"), QStringLiteral("Item"));
+        }
+        item.insert(QStringLiteral("id"), QStringLiteral("item%1").arg(i));
+        item.insert(QStringLiteral("name"), QStringLiteral("Item %1").arg(i));
+        item.insert(QStringLiteral("properties"), properties);
+        items.append(item);
+    }
+    QJsonObject scene;
+    scene.insert(QStringLiteral("id"), QStringLiteral("bench"));
+    scene.insert(QStringLiteral("items"), items);
+    QJsonObject root;
+    root.insert(QStringLiteral("scene"), scene);
+    return root;
+}
+
+bool writeFile(const QString& path, const QByteArray& data) {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+// Average time of Scene::load(url), items built included, over runs.
+qint64 timeLoadNs(const QString& url, int runs, int expectedItems) {
+    QElapsedTimer timer;
+    qint64 totalNs = 0;
+    for (int i = 0; i < runs; ++i) {
+        Scene scene;
+        timer.start();
+        const bool loaded = scene.load(url);
+        totalNs += timer.nsecsElapsed();
+        if (!loaded || scene.getItems().size() != expectedItems) {
+            qWarning() << "Scene load failed or incomplete:" << url << scene.getItems().size() << "items";
+            return -1;
+        }
+    }
+    return totalNs / runs;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("qt-galgame-scenebench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+        "Times Scene::load() of a generated scene from its JSON against its compiled CBOR form."));
+    parser.addHelpOption();
+    const QCommandLineOption itemsOption(QStringLiteral("items"), QStringLiteral("Items in the generated scene."),
+                                         QStringLiteral("count"), QStringLiteral("10000"));
+    const QCommandLineOption runsOption(QStringLiteral("runs"), QStringLiteral("Loads per format."),
+                                        QStringLiteral("count"), QStringLiteral("5"));
+    parser.addOption(itemsOption);
+    parser.addOption(runsOption);
+    parser.process(app);
+
+    const int itemCount = intOption(parser, itemsOption, 10000);
+    const int runs = intOption(parser, runsOption, 5);
+    Registration::getInstance().registerFactory(QSharedPointer<NativeItemFactory>::create());
+    // Character items resolve their portraits through Resources; set it up
+    // before timing so the first run does not pay for it.
+    Resources::getInstance();
+
+    QTemporaryDir directory;
+    if (!directory.isValid()) {
+        qWarning() << "Cannot create a temporary directory";
+        return 1;
+    }
+    const QJsonObject root = makeScene(itemCount);
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    const QByteArray cbor = CompiledSceneFormat::compile(root, json);
+    // The CBOR is not named like a sibling of the JSON, or loading the JSON
+    // would pick it up instead.
+    const QString jsonPath = directory.filePath(QStringLiteral("bench.json"));
+    const QString cborPath = directory.filePath(QStringLiteral("bench-compiled.cbor"));
+    if (!writeFile(jsonPath, json) || !writeFile(cborPath, cbor)) {
+        qWarning() << "Cannot write the generated scene to" << directory.path();
+        return 1;
+    }
+
+    const qint64 jsonNs = timeLoadNs(jsonPath, runs, itemCount);
+    const qint64 cborNs = timeLoadNs(cborPath, runs, itemCount);
+    if (jsonNs < 0 || cborNs < 0) {
+        return 1;
+    }
+    qDebug().noquote() << QStringLiteral("%1 items, %2 runs: JSON %3 bytes, %4 ms/load; CBOR %5 bytes, %6 ms/load")
+                              .arg(itemCount).arg(runs)
+                              .arg(json.size()).arg(jsonNs / 1e6, 0, 'f', 2)
+                              .arg(cbor.size()).arg(cborNs / 1e6, 0, 'f', 2);
+    return 0;
+}
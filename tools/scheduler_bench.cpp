@@ -0,0 +1,234 @@
+#include "core/CancellationToken.h"
+#include "core/TaskScheduler.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace {
+
+// Execution::Priority::Visible, the class most loads run in.
+constexpr int BenchPriority = 1;
+
+struct RunResult {
+    qint64 totalNs = 0;
+    qint64 p50Ns = 0;
+    qint64 p99Ns = 0;
+    qint64 maxNs = 0;
+};
+
+int intOption(const QCommandLineParser& parser, const QCommandLineOption& option, int fallback) {
+    bool ok = false;
+    const int value = parser.value(option).toInt(&ok);
+    return ok && value > 0 ? value : fallback;
+}
+
+void spin(qint64 workNs) {
+    if (workNs <= 0) {
+        return;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.nsecsElapsed() < workNs) {
+    }
+}
+
+// Submits taskCount tiny tasks through submit and waits for all of them.
+// Latency is from a task's submission until it starts running.
+RunResult runBatch(int taskCount, qint64 workNs,
+                   const std::function<void(std::function<void()>)>& submit) {
+    std::vector<qint64> submittedNs(static_cast<size_t>(taskCount));
+    std::vector<qint64> startedNs(static_cast<size_t>(taskCount));
+    std::atomic<int> remaining(taskCount);
+    QSemaphore done;
+    QElapsedTimer clock;
+    clock.start();
+    for (int i = 0; i < taskCount; ++i) {
+        submittedNs[static_cast<size_t>(i)] = clock.nsecsElapsed();
+        submit([&, i]() {
+            startedNs[static_cast<size_t>(i)] = clock.nsecsElapsed();
+            spin(workNs);
+            if (remaining.fetch_sub(1) == 1) {
+                done.release();
+            }
+        });
+    }
+    done.acquire();
+
+    RunResult result;
+    result.totalNs = clock.nsecsElapsed();
+    std::vector<qint64> latencies(static_cast<size_t>(taskCount));
+    for (size_t i = 0; i < latencies.size(); ++i) {
+        latencies[i] = startedNs[i] - submittedNs[i];
+    }
+    std::sort(latencies.begin(), latencies.end());
+    result.p50Ns = latencies[latencies.size() / 2];
+    result.p99Ns = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+    result.maxNs = latencies.back();
+    return result;
+}
+
+// One root fans out to chainCount chains of stageCount tasks, which join in
+// one final task: the shape of a batch of staged loads.  TaskScheduler runs
+// it as a TaskGraph, so each stage is released onto the worker that finished
+// the one before and idle workers steal; QThreadPool gets the same shape by
+// starting each next stage from the one before.
+qint64 runGraphBatch(TaskScheduler& scheduler, int chainCount, int stageCount, qint64 workNs,
+                     const CancellationToken& token) {
+    TaskGraph graph;
+    const TaskGraph::Node root = graph.add([workNs]() {
+        spin(workNs);
+    });
+    const TaskGraph::Node join = graph.add([workNs]() {
+        spin(workNs);
+    });
+    for (int chain = 0; chain < chainCount; ++chain) {
+        TaskGraph::Node previous = root;
+        for (int stage = 0; stage < stageCount; ++stage) {
+            const TaskGraph::Node node = graph.add([workNs]() {
+                spin(workNs);
+            });
+            graph.precede(previous, node);
+            previous = node;
+        }
+        graph.precede(previous, join);
+    }
+    QElapsedTimer clock;
+    clock.start();
+    scheduler.submitGraph(std::move(graph), BenchPriority, token).waitForFinished();
+    return clock.nsecsElapsed();
+}
+
+qint64 runPoolChains(QThreadPool& pool, int chainCount, int stageCount, qint64 workNs) {
+    std::atomic<int> remaining(chainCount);
+    QSemaphore done;
+    // Shared by every stage; outlives them through waitForDone() below.
+    std::function<void(int)> runStage;
+    runStage = [&](int stage) {
+        spin(workNs);
+        if (stage + 1 < stageCount) {
+            pool.start([&runStage, stage]() {
+                runStage(stage + 1);
+            });
+        } else if (remaining.fetch_sub(1) == 1) {
+            spin(workNs);
+            done.release();
+        }
+    };
+    QElapsedTimer clock;
+    clock.start();
+    pool.start([&]() {
+        spin(workNs);
+        for (int chain = 0; chain < chainCount; ++chain) {
+            pool.start([&runStage]() {
+                runStage(0);
+            });
+        }
+    });
+    done.acquire();
+    const qint64 elapsedNs = clock.nsecsElapsed();
+    // Stages may still be returning from pool.start() into runStage.
+    pool.waitForDone();
+    return elapsedNs;
+}
+
+void reportGraph(const char* name, int taskCount, qint64 totalNs, const QString& extra) {
+    const double seconds = static_cast<double>(totalNs) / 1e9;
+    qDebug().noquote() << QStringLiteral("%1 %2 tasks/s, %3 ms%4")
+                              .arg(QLatin1String(name), -12)
+                              .arg(static_cast<qint64>(taskCount / seconds), 10)
+                              .arg(totalNs / 1e6, 0, 'f', 1)
+                              .arg(extra);
+}
+
+void report(const char* name, int taskCount, const RunResult& result) {
+    const double seconds = static_cast<double>(result.totalNs) / 1e9;
+    qDebug().noquote() << QStringLiteral("%1 %2 tasks/s, start latency p50 %3 us, p99 %4 us, max %5 us")
+                              .arg(QLatin1String(name), -12)
+                              .arg(static_cast<qint64>(taskCount / seconds), 10)
+                              .arg(result.p50Ns / 1000.0, 0, 'f', 1)
+                              .arg(result.p99Ns / 1000.0, 0, 'f', 1)
+                              .arg(result.maxNs / 1000.0, 0, 'f', 1);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("qt-galgame-schedbench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+        "Compares TaskScheduler with QThreadPool on batches of tiny tasks and on "
+        "fan-out graphs of task chains."));
+    parser.addHelpOption();
+    const QCommandLineOption tasksOption(QStringLiteral("tasks"), QStringLiteral("Tasks per batch."),
+                                         QStringLiteral("count"), QStringLiteral("100000"));
+    const QCommandLineOption workersOption(QStringLiteral("workers"), QStringLiteral("Worker threads for both."),
+                                           QStringLiteral("count"));
+    const QCommandLineOption workOption(QStringLiteral("work-ns"), QStringLiteral("Busy work per task."),
+                                        QStringLiteral("ns"), QStringLiteral("0"));
+    const QCommandLineOption roundsOption(QStringLiteral("rounds"), QStringLiteral("Batches per scheduler."),
+                                          QStringLiteral("count"), QStringLiteral("5"));
+    parser.addOption(tasksOption);
+    parser.addOption(workersOption);
+    parser.addOption(workOption);
+    const QCommandLineOption chainsOption(QStringLiteral("chains"), QStringLiteral("Chains in the graph case."),
+                                          QStringLiteral("count"), QStringLiteral("1000"));
+    const QCommandLineOption stagesOption(QStringLiteral("stages"), QStringLiteral("Tasks per chain in the graph case."),
+                                          QStringLiteral("count"), QStringLiteral("4"));
+    parser.addOption(roundsOption);
+    parser.addOption(chainsOption);
+    parser.addOption(stagesOption);
+    parser.process(app);
+
+    const int taskCount = intOption(parser, tasksOption, 100000);
+    const int workerCount = intOption(parser, workersOption, QThread::idealThreadCount());
+    const qint64 workNs = parser.value(workOption).toLongLong();
+    const int rounds = intOption(parser, roundsOption, 5);
+    const int chainCount = intOption(parser, chainsOption, 1000);
+    const int stageCount = intOption(parser, stagesOption, 4);
+    const int graphTaskCount = chainCount * stageCount + 2;
+    qDebug().noquote() << QStringLiteral("%1 tasks x %2 rounds, %3 workers, %4 ns work per task")
+                              .arg(taskCount).arg(rounds).arg(workerCount).arg(workNs);
+
+    TaskScheduler scheduler;
+    scheduler.setWorkerCount(workerCount);
+    QThreadPool pool;
+    pool.setMaxThreadCount(workerCount);
+    const CancellationToken token;
+
+    // Alternate the two so neither always runs on a cold or a warm machine.
+    for (int round = 0; round < rounds; ++round) {
+        const RunResult schedulerResult = runBatch(taskCount, workNs, [&](std::function<void()> work) {
+            scheduler.submit(std::move(work), BenchPriority, token);
+        });
+        report("TaskScheduler", taskCount, schedulerResult);
+        const RunResult poolResult = runBatch(taskCount, workNs, [&](std::function<void()> work) {
+            pool.start(std::move(work));
+        });
+        report("QThreadPool", taskCount, poolResult);
+    }
+
+    qDebug().noquote() << QStringLiteral("graph: 1 root -> %1 chains x %2 stages -> 1 join")
+                              .arg(chainCount).arg(stageCount);
+    for (int round = 0; round < rounds; ++round) {
+        const quint64 stolenBefore = scheduler.getStolenTaskCount();
+        const qint64 graphNs = runGraphBatch(scheduler, chainCount, stageCount, workNs, token);
+        reportGraph("TaskGraph", graphTaskCount, graphNs,
+                    QStringLiteral(", %1 stolen").arg(scheduler.getStolenTaskCount() - stolenBefore));
+        reportGraph("QThreadPool", graphTaskCount, runPoolChains(pool, chainCount, stageCount, workNs), QString());
+    }
+    scheduler.shutdown();
+    pool.waitForDone();
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "resources/SoundMixerDevice.h"
+
+#include <QAudioFormat>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QThread>
+
+#include <atomic>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+constexpr qint64 NanosecondsPerMillisecond = 1000000;
+
+struct BenchOptions {
+    int periodMs = 10;
+    int bufferMs = 40;
+    int triggers = 1000;
+    int clipMs = 50;
+    int maxVoices = 16;
+    int sampleRate = 48000;
+    int channels = 2;
+};
+
+int intOption(const QCommandLineParser& parser, const QCommandLineOption& option, int fallback) {
+    bool ok = false;
+    const int value = parser.value(option).toInt(&ok);
+    return ok && value > 0 ? value : fallback;
+}
+
+QByteArray makeClip(const QAudioFormat& format, int clipMs) {
+    // A 440 Hz tone; content does not matter to the mixer, but it keeps the
+    // mixing loop doing real work.
+    const qint32 frames = format.framesForDuration(static_cast<qint64>(clipMs) * 1000);
+    QByteArray pcm(frames * format.bytesPerFrame(), Qt::Uninitialized);
+    auto* samples = reinterpret_cast<qint16*>(pcm.data());
+    for (qint32 frame = 0; frame < frames; ++frame) {
+        const double phase = 2.0 * std::numbers::pi * 440.0 * frame / format.sampleRate();
+        const auto sample = static_cast<qint16>(std::sin(phase) * 8000.0);
+        for (int channel = 0; channel < format.channelCount(); ++channel) {
+            samples[frame * format.channelCount() + channel] = sample;
+        }
+    }
+    return pcm;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("qt-galgame-soundbench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+        "Measures sound effect trigger-to-output latency through the SoundEffects mixer, "
+        "pulled by a simulated sink instead of an audio device."));
+    parser.addHelpOption();
+    const QCommandLineOption periodOption(QStringLiteral("period-ms"), QStringLiteral("Sink pull period."),
+                                          QStringLiteral("ms"), QStringLiteral("10"));
+    const QCommandLineOption bufferOption(QStringLiteral("buffer-ms"),
+                                          QStringLiteral("Sink buffer still to play after a pull."),
+                                          QStringLiteral("ms"), QStringLiteral("40"));
+    const QCommandLineOption triggersOption(QStringLiteral("triggers"), QStringLiteral("Clips to trigger."),
+                                            QStringLiteral("count"), QStringLiteral("1000"));
+    const QCommandLineOption clipOption(QStringLiteral("clip-ms"), QStringLiteral("Length of each clip."),
+                                        QStringLiteral("ms"), QStringLiteral("50"));
+    const QCommandLineOption voicesOption(QStringLiteral("max-voices"), QStringLiteral("Mixer voice limit."),
+                                          QStringLiteral("count"), QStringLiteral("16"));
+    parser.addOption(periodOption);
+    parser.addOption(bufferOption);
+    parser.addOption(triggersOption);
+    parser.addOption(clipOption);
+    parser.addOption(voicesOption);
+    parser.process(app);
+
+    BenchOptions options;
+    options.periodMs = intOption(parser, periodOption, options.periodMs);
+    options.bufferMs = intOption(parser, bufferOption, options.bufferMs);
+    options.triggers = intOption(parser, triggersOption, options.triggers);
+    options.clipMs = intOption(parser, clipOption, options.clipMs);
+    options.maxVoices = intOption(parser, voicesOption, options.maxVoices);
+
+    QAudioFormat format;
+    format.setSampleRate(options.sampleRate);
+    format.setChannelCount(options.channels);
+    format.setSampleFormat(QAudioFormat::Int16);
+
+    SoundMixerDevice mixer(options.maxVoices);
+    mixer.setFrameBytes(format.bytesPerFrame());
+    mixer.open(QIODevice::ReadOnly);
+    const QByteArray clip = makeClip(format, options.clipMs);
+
+    // The simulated sink: pulls one period of audio every period, on its own
+    // thread, like a QAudioSink in pull mode.
+    std::atomic<bool> stopping(false);
+    QThread* sinkThread = QThread::create([&]() {
+        QByteArray buffer(format.bytesForDuration(static_cast<qint64>(options.periodMs) * 1000), Qt::Uninitialized);
+        QElapsedTimer clock;
+        clock.start();
+        qint64 nextPullNs = 0;
+        while (!stopping.load()) {
+            mixer.read(buffer.data(), buffer.size());
+            nextPullNs += options.periodMs * NanosecondsPerMillisecond;
+            const qint64 waitNs = nextPullNs - clock.nsecsElapsed();
+            if (waitNs > 0) {
+                QThread::usleep(static_cast<unsigned long>(waitNs / 1000));
+            }
+        }
+    });
+    sinkThread->start(QThread::TimeCriticalPriority);
+
+    // Triggers come at random gaps of up to three periods, as UI clicks would, so
+    // they land anywhere within a pull period.
+    QElapsedTimer wallClock;
+    wallClock.start();
+    QRandomGenerator random(0x5eed);
+    for (int i = 0; i < options.triggers; ++i) {
+        const qint64 gapUs = random.bounded(options.periodMs * 3 * 1000);
+        QThread::usleep(static_cast<unsigned long>(gapUs));
+        mixer.addVoice(clip, 0.5f);
+    }
+    // Let the last triggers be mixed before stopping the sink.
+    QThread::msleep(static_cast<unsigned long>(options.periodMs * 2));
+    stopping = true;
+    sinkThread->wait();
+    delete sinkThread;
+
+    const SoundMixerDevice::Stats stats = mixer.getStats();
+    const qint64 bufferUs = static_cast<qint64>(options.bufferMs) * 1000;
+    qDebug().noquote() << QStringLiteral("period %1 ms, sink buffer %2 ms, %3 ms clips, %4 voices, %5 s")
+                              .arg(options.periodMs).arg(options.bufferMs).arg(options.clipMs)
+                              .arg(options.maxVoices).arg(wallClock.elapsed() / 1000.0, 0, 'f', 1);
+    qDebug().noquote() << QStringLiteral("triggers %1, dropped %2").arg(stats.triggers).arg(stats.dropped);
+    qDebug().noquote() << QStringLiteral("trigger-to-mix     avg %1 us, max %2 us")
+                              .arg(stats.averageLatencyUs).arg(stats.maxLatencyUs);
+    // A mixed frame is heard once the sink buffer ahead of it has played.
+    qDebug().noquote() << QStringLiteral("trigger-to-output  avg %1 us, max %2 us (mix + sink buffer)")
+                              .arg(stats.averageLatencyUs + bufferUs).arg(stats.maxLatencyUs + bufferUs);
+    return 0;
+}